@@ -0,0 +1,85 @@
+#ifndef KEDIXA_MODINT_H
+#define KEDIXA_MODINT_H
+
+#include "kedixa/modular.h"
+
+#include <memory>
+#include <string>
+
+namespace kedixa {
+
+// An integer modulo a fixed odd N. The modints of the same modulus share one
+// montgomery_context, and keep their values in Montgomery form, so a
+// multiplication costs a product of size() limbs and a Montgomery
+// reduction instead of a long division. All the results are reduced.
+//
+// The shared context holds scratch space, so the modints of one context
+// must be used by one thread at a time.
+class modint {
+public:
+    using size_type   = unsigned_bigint::size_type;
+    using uint_type   = unsigned_bigint::uint_type;
+    using ubigint     = unsigned_bigint;
+    using context_ptr = std::shared_ptr<const montgomery_context>;
+
+public:
+    // constructors, value is reduced modulo N
+    modint(const context_ptr &ctx, const ubigint &value = ubigint(0u));
+    modint(const context_ptr &ctx, const uint_type value);
+    modint(const modint&) = default;
+    modint(modint&&) = default;
+
+    // a new context for modulus, which must be odd
+    static context_ptr make_context(const ubigint &modulus);
+
+    // assignment operators, both sides must have the same modulus
+    modint& operator= (const modint&) = default;
+    modint& operator= (modint&&) = default;
+    modint& operator+=(const modint&);
+    modint& operator-=(const modint&);
+    modint& operator*=(const modint&);
+    modint& operator/=(const modint&); // multiply by the inverse
+
+    // arithmetic operators
+    friend modint operator+ (const modint &lhs, const modint &rhs)
+    { modint tmp(lhs); return std::move(tmp += rhs); }
+    friend modint operator- (const modint &lhs, const modint &rhs)
+    { modint tmp(lhs); return std::move(tmp -= rhs); }
+    friend modint operator* (const modint &lhs, const modint &rhs)
+    { modint tmp(lhs); return std::move(tmp *= rhs); }
+    friend modint operator/ (const modint &lhs, const modint &rhs)
+    { modint tmp(lhs); return std::move(tmp /= rhs); }
+    modint operator- () const;
+
+    // relational operators
+    friend bool operator==(const modint &lhs, const modint &rhs) noexcept
+    { return lhs.ctx->modulus() == rhs.ctx->modulus() && lhs.mont == rhs.mont; }
+    friend bool operator!=(const modint &lhs, const modint &rhs) noexcept
+    { return !(lhs == rhs); }
+
+    // others
+    const context_ptr& context() const noexcept { return ctx; }
+    const ubigint& modulus() const noexcept { return ctx->modulus(); }
+    // the value in [0, N)
+    ubigint value() const;
+    bool is_zero() const noexcept { return mont == 0; }
+    // (*this)^exp
+    modint pow(const ubigint &exp) const;
+    // the multiplicative inverse, throw std::runtime_error if it does not exist
+    modint inverse() const;
+    std::string to_string() const { return value().to_string(); }
+    void swap(modint &) noexcept;
+
+private:
+    modint(const context_ptr &ctx, ubigint &&mont, bool);
+    void check_context(const modint &) const;
+
+    context_ptr ctx;
+    ubigint mont;           // value * R mod N
+}; // class modint
+
+void swap(modint&, modint&) noexcept;
+
+} // namespace kedixa
+
+#endif // KEDIXA_MODINT_H
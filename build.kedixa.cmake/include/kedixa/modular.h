@@ -0,0 +1,172 @@
+#ifndef KEDIXA_MODULAR_H
+#define KEDIXA_MODULAR_H
+
+#include "kedixa/unsigned_bigint.h"
+
+#include <vector>
+
+namespace kedixa {
+
+// Montgomery reduction for a fixed odd modulus N. Numbers are kept in
+// Montgomery form x * R mod N, where R = 2^(32 * size()), then mul and sqr
+// only need multiplications, and no division is done in modular loops.
+//
+// The limb interface works on spans of size() limbs (values less than N,
+// padded with zero limbs), and never allocates. The unsigned_bigint
+// interface reuses the limbs of the numbers passed in, and mul_eq, sqr_eq
+// do not allocate once the numbers have size() limbs of capacity.
+//
+// A context keeps its scratch space inside, so it must not be used by
+// several threads at the same time, copy it for each thread instead.
+class montgomery_context {
+public:
+    using size_type = unsigned_bigint::size_type;
+    using uint_type = unsigned_bigint::uint_type;
+    using ubigint   = unsigned_bigint;
+
+public:
+    // modulus must be odd
+    explicit montgomery_context(const ubigint &modulus);
+
+    const ubigint& modulus() const noexcept { return mod; }
+    // the number of limbs of the Montgomery form, R = 2^(32 * size())
+    size_type size() const noexcept { return w; }
+
+    // x * R mod N, x may be not less than N
+    ubigint to_mont(const ubigint &x) const;
+    // x / R mod N
+    ubigint from_mont(const ubigint &x) const;
+    // a * b / R mod N, and a * a / R mod N, a, b < N
+    ubigint mul(const ubigint &a, const ubigint &b) const;
+    ubigint sqr(const ubigint &a) const;
+    void mul_eq(ubigint &a, const ubigint &b) const;
+    void sqr_eq(ubigint &a) const;
+    // x / R mod N, x < N * R
+    ubigint reduce(const ubigint &x) const;
+
+    // limb interface, rp may be the same as an input
+    void to_mont(uint_type *rp, const uint_type *ap) const noexcept;
+    void from_mont(uint_type *rp, const uint_type *ap) const noexcept;
+    void mul(uint_type *rp, const uint_type *ap, const uint_type *bp) const noexcept;
+    void sqr(uint_type *rp, const uint_type *ap) const noexcept;
+    // (rp, size()) = (tp, 2 * size()) / R mod N, tp < N * R is destroyed
+    void reduce(uint_type *rp, uint_type *tp) const noexcept;
+
+private:
+    void load(uint_type *p, const ubigint &x) const noexcept;
+    void store(ubigint &x, const uint_type *p) const;
+
+    ubigint mod;
+    size_type n, w;         // limbs of the modulus, and of the Montgomery form
+    uint_type minv;         // -1/N mod 2^32
+    std::vector<uint_type> m, r2, one; // N, R^2 mod N and 1 on w limbs
+    mutable std::vector<uint_type> ws; // two operands and mont_mul scratch
+}; // class montgomery_context
+
+// Barrett reduction for a fixed modulus N of n limbs, x mod N is computed
+// from the precomputed reciprocal mu = floor(2^(64n) / N) with two
+// multiplications and at most a few subtractions, without any division.
+//
+// The limb interface works on spans of size() limbs (products of 2 * size()
+// limbs for reduce) and never allocates, the unsigned_bigint interface is
+// like the one of montgomery_context. The same thread rule applies.
+class barrett_context {
+public:
+    using size_type = unsigned_bigint::size_type;
+    using uint_type = unsigned_bigint::uint_type;
+    using ubigint   = unsigned_bigint;
+
+public:
+    // modulus must not be zero
+    explicit barrett_context(const ubigint &modulus);
+
+    const ubigint& modulus() const noexcept { return mod; }
+    size_type size() const noexcept { return n; }
+
+    // x mod N for any x
+    ubigint reduce(const ubigint &x) const;
+    // a * b mod N, and a * a mod N, a, b < N
+    ubigint mul(const ubigint &a, const ubigint &b) const;
+    ubigint sqr(const ubigint &a) const;
+    void mul_eq(ubigint &a, const ubigint &b) const;
+    void sqr_eq(ubigint &a) const;
+
+    // limb interface, rp may be the same as an input
+    // (rp, size()) = (xp, 2 * size()) mod N
+    void reduce(uint_type *rp, const uint_type *xp) const noexcept;
+    void mul(uint_type *rp, const uint_type *ap, const uint_type *bp) const noexcept;
+    void sqr(uint_type *rp, const uint_type *ap) const noexcept;
+
+private:
+    void load(uint_type *p, const ubigint &x) const noexcept;
+    void store(ubigint &x, const uint_type *p) const;
+
+    ubigint mod;
+    size_type n;
+    std::vector<uint_type> m, mu;      // N and mu on n + 1 limbs
+    mutable std::vector<uint_type> ws; // operands, products and mul_n scratch
+}; // class barrett_context
+
+// A product tree of a fixed set of single limb moduli m_i, for reducing a
+// number modulo all of them at once, and for the Chinese remainder theorem.
+// The moduli are packed into groups whose product fits in a limb, the groups
+// are the leaves, and each node keeps the product of its subtree and, when
+// it is long, a barrett_context of it. Then x mod m_i is computed down the
+// tree, each node reducing the remainder of its parent, and the cost is a
+// few multiplications of each size instead of one pass over x per modulus.
+//
+// The tree is built once, so the same context should be reused for a fixed
+// set of moduli. The thread rule of barrett_context applies.
+class multi_mod_context {
+public:
+    using size_type = unsigned_bigint::size_type;
+    using uint_type = unsigned_bigint::uint_type;
+    using ubigint   = unsigned_bigint;
+
+public:
+    // the moduli must not be zero, they may repeat, throw std::runtime_error
+    explicit multi_mod_context(const std::vector<uint_type> &moduli);
+
+    const std::vector<uint_type>& moduli() const noexcept { return mods; }
+    // the product M of the moduli, 1 for none
+    const ubigint& product() const noexcept { return tree.back()[0].prod; }
+    // whether the moduli are pairwise coprime, which crt needs
+    bool coprime() const;
+
+    // rs[i] = x mod m_i
+    std::vector<uint_type> residues(const ubigint &x) const;
+    void residues(const ubigint &x, std::vector<uint_type> &rs) const;
+    // the x in [0, M) with x mod m_i = rs[i] mod m_i, the moduli must be
+    // pairwise coprime and rs must have one residue for each modulus,
+    // otherwise throw std::runtime_error
+    ubigint crt(const std::vector<uint_type> &rs) const;
+
+private:
+    struct node {
+        ubigint prod;
+        size_type ctx;      // the index in ctxs, or npos for a short product
+    };
+    static const size_type npos = size_type(-1);
+
+    ubigint reduce(const node &nd, const ubigint &x) const;
+    // the inverses for crt, computed on the first use
+    void prepare_crt() const;
+
+    std::vector<uint_type> mods;
+    std::vector<size_type> first;       // the first modulus of each group
+    std::vector<std::vector<node>> tree; // the groups first, the root last
+    std::vector<barrett_context> ctxs;
+    mutable std::vector<uint_type> inv; // (M / m_i)^(-1) mod m_i
+    mutable bool crt_ready, is_coprime;
+}; // class multi_mod_context
+
+// x mod moduli[i] for each i, and the Chinese remainder of rs modulo the
+// moduli, by a multi_mod_context used once
+std::vector<unsigned_bigint::uint_type>
+multi_mod(const unsigned_bigint &x, const std::vector<unsigned_bigint::uint_type> &moduli);
+unsigned_bigint crt(const std::vector<unsigned_bigint::uint_type> &rs,
+                    const std::vector<unsigned_bigint::uint_type> &moduli);
+
+} // namespace kedixa
+
+#endif // KEDIXA_MODULAR_H
@@ -0,0 +1,197 @@
+#ifndef KEDIXA_MPN_H
+#define KEDIXA_MPN_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace kedixa {
+
+// Low level arithmetic on natural numbers stored as spans of limbs,
+// (ptr, n) means ptr[0] + ptr[1] * B + ... + ptr[n-1] * B^(n-1) where
+// B = 2^LIMB_BITS. The spans are owned by the caller, so these functions
+// work on any buffer, e.g. limbs received from a socket or a mmapped table.
+//
+// Unless noted, n >= 1, the result span rp has room for the result, and rp
+// may be the same as an input span but must not partially overlap it.
+namespace mpn {
+
+using limb_type  = uint32_t;
+using dlimb_type = uint64_t;
+using size_type  = size_t;
+
+static const unsigned  LIMB_BITS = sizeof(limb_type) * 8;
+// mul and sqr switch to Karatsuba when both operands have this many limbs
+static const size_type MUL_KARATSUBA_THRESHOLD = 32;
+// the half gcd recursion is used above these sizes, for its inner steps and
+// for gcd
+static const size_type HGCD_THRESHOLD = 100;
+static const size_type GCD_DC_THRESHOLD = 300;
+
+// compare (ap, n) with (bp, n), return <0, 0 or >0
+int cmp(const limb_type *ap, const limb_type *bp, size_type n) noexcept;
+// return n without the leading zero limbs of (ap, n), n may be 0
+size_type normalize(const limb_type *ap, size_type n) noexcept;
+
+// rp = ap + bp, return the carry
+limb_type add_n(limb_type *rp, const limb_type *ap, const limb_type *bp, size_type n) noexcept;
+// rp = ap + b, n may be 0, return the carry
+limb_type add_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept;
+// rp = (ap, an) + (bp, bn), an >= bn, return the carry
+limb_type add(limb_type *rp, const limb_type *ap, size_type an,
+              const limb_type *bp, size_type bn) noexcept;
+// rp = ap - bp, return the borrow
+limb_type sub_n(limb_type *rp, const limb_type *ap, const limb_type *bp, size_type n) noexcept;
+// rp = ap - b, n may be 0, return the borrow
+limb_type sub_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept;
+// rp = (ap, an) - (bp, bn), an >= bn, return the borrow
+limb_type sub(limb_type *rp, const limb_type *ap, size_type an,
+              const limb_type *bp, size_type bn) noexcept;
+
+// rp = ap * b, return the high limb
+limb_type mul_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept;
+// rp += ap * b, return the carry
+limb_type addmul_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept;
+// rp -= ap * b, return the borrow
+limb_type submul_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept;
+// (rp, an + bn) = (ap, an) * (bp, bn), an >= bn >= 1,
+// rp must not overlap the operands
+void mul(limb_type *rp, const limb_type *ap, size_type an,
+         const limb_type *bp, size_type bn);
+// (rp, 2n) = (ap, n)^2, rp must not overlap ap
+void sqr(limb_type *rp, const limb_type *ap, size_type n);
+// the scratch space needed by mul_n and sqr_n
+size_type mul_n_itch(size_type n) noexcept;
+// (rp, 2n) = (ap, n) * (bp, n) without allocation, ws has mul_n_itch(n)
+// limbs, rp must not overlap the operands or ws
+void mul_n(limb_type *rp, const limb_type *ap, const limb_type *bp,
+           size_type n, limb_type *ws) noexcept;
+// (rp, 2n) = (ap, n)^2 without allocation, like mul_n
+void sqr_n(limb_type *rp, const limb_type *ap, size_type n, limb_type *ws) noexcept;
+
+// qp = ap / d, return ap % d, d != 0, qp has n limbs
+limb_type divrem_1(limb_type *qp, const limb_type *ap, size_type n, limb_type d) noexcept;
+// return ap % d, d != 0
+limb_type mod_1(const limb_type *ap, size_type n, limb_type d) noexcept;
+// (qp, an - dn + 1) = (ap, an) / (dp, dn), (rp, dn) = (ap, an) % (dp, dn),
+// an >= dn >= 1 and dp[dn-1] != 0. qp may be nullptr if the quotient is
+// not needed. qp and rp may overlap the operands, but not each other.
+void divrem(limb_type *qp, limb_type *rp, const limb_type *ap, size_type an,
+            const limb_type *dp, size_type dn);
+// the scratch space needed by divrem with ws
+size_type divrem_itch(size_type an, size_type dn) noexcept;
+// divrem without allocation, ws has divrem_itch(an, dn) limbs and must not
+// overlap the operands
+void divrem(limb_type *qp, limb_type *rp, const limb_type *ap, size_type an,
+            const limb_type *dp, size_type dn, limb_type *ws) noexcept;
+
+// return -1/m0 mod B, m0 is odd
+limb_type mont_inverse(limb_type m0) noexcept;
+// Montgomery reduction, (rp, n) = (tp, 2n) / B^n mod (mp, n), where mp is
+// odd, tp < mp * B^n and minv = mont_inverse(mp[0]), tp is destroyed
+void redc(limb_type *rp, limb_type *tp, const limb_type *mp, size_type n,
+          limb_type minv) noexcept;
+// the number of limbs that mont_mul works best on for an n limbs modulus,
+// the modulus is padded with zero limbs to this size
+size_type mont_size(size_type n) noexcept;
+// the scratch space needed by mont_mul
+size_type mont_mul_itch(size_type n) noexcept;
+// Montgomery multiplication without allocation, (rp, n) = ap * bp / B^n
+// mod (mp, n), where ap, bp < mp, mp is odd, minv = mont_inverse(mp[0])
+// and tp has mont_mul_itch(n) limbs, rp may be the same as ap or bp
+void mont_mul(limb_type *rp, const limb_type *ap, const limb_type *bp,
+              const limb_type *mp, size_type n, limb_type minv, limb_type *tp) noexcept;
+// (rp, n) = (bp, bn)^(ep, en) mod (mp, n), mp[n-1] != 0, the operands may
+// overlap rp, sliding window exponentiation in Montgomery form if mp is odd
+void powm(limb_type *rp, const limb_type *bp, size_type bn,
+          const limb_type *ep, size_type en, const limb_type *mp, size_type n);
+
+// (rp, return value) = gcd((ap, an), (bp, bn)) by Lehmer's algorithm, or
+// by the subquadratic half gcd above GCD_DC_THRESHOLD limbs, the operands
+// are destroyed, rp has max(an, bn) limbs and must not overlap
+// them, return 0 if both are zero
+size_type gcd(limb_type *rp, limb_type *ap, size_type an, limb_type *bp, size_type bn);
+// (gp, return value) = g = gcd((ap, an), (bp, bn)) like gcd, and (sp, |sn|)
+// with the sign of sn is s, such that g = s * a + t * b for some t, and
+// |s| <= b / g. b must not be zero, gp has max(an, bn) limbs and sp has bn
+// limbs, t can be computed as (g - s * a) / b
+size_type gcdext(limb_type *gp, limb_type *sp, std::ptrdiff_t &sn,
+                 limb_type *ap, size_type an, limb_type *bp, size_type bn);
+
+// rp = ap << cnt, 0 <= cnt < LIMB_BITS, return the bits shifted out
+// (in the low bits), rp >= ap is allowed
+limb_type lshift(limb_type *rp, const limb_type *ap, size_type n, unsigned cnt) noexcept;
+// rp = ap >> cnt, 0 <= cnt < LIMB_BITS, return the bits shifted out
+// (in the high bits), rp <= ap is allowed
+limb_type rshift(limb_type *rp, const limb_type *ap, size_type n, unsigned cnt) noexcept;
+
+// the number of leading and trailing zero bits of x != 0, and of one bits
+inline unsigned clz(limb_type x) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_clz(x);
+#else
+    unsigned cnt = 0;
+    for(; !(x >> (LIMB_BITS - 1)); x <<= 1) ++cnt;
+    return cnt;
+#endif
+}
+inline unsigned ctz(limb_type x) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#else
+    unsigned cnt = 0;
+    for(; !(x & 1); x >>= 1) ++cnt;
+    return cnt;
+#endif
+}
+inline unsigned popcount(limb_type x) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_popcount(x);
+#else
+    unsigned cnt = 0;
+    for(; x; x &= x - 1) ++cnt;
+    return cnt;
+#endif
+}
+// the number of one bits of (ap, n), n may be 0
+size_type popcount(const limb_type *ap, size_type n) noexcept;
+
+// a 64-bit hash of (ap, n) and seed, n may be 0. It is defined on the limb
+// values, not on their bytes in memory, and has no random state, so it is
+// the same across runs and byte orders and may be stored.
+uint64_t hash(const limb_type *ap, size_type n, uint64_t seed = 0) noexcept;
+
+// A read only view of a natural number in a span of limbs owned by someone
+// else, leading zero limbs are ignored. It is accepted by the arithmetic
+// of unsigned_bigint, so foreign limbs need not be copied into a number.
+// The span must outlive the view and must not be changed while in use.
+class const_view {
+public:
+    using const_iterator = const limb_type*;
+
+    const_view(const limb_type *limbs, size_type count) noexcept
+        : p(limbs), n(normalize(limbs, count))
+    { if(n == 0) p = &ZERO, n = 1; }
+
+    const limb_type* data() const noexcept { return p; }
+    // the number of limbs without leading zeros, at least 1
+    size_type size() const noexcept { return n; }
+    limb_type operator[](size_type i) const noexcept { return p[i]; }
+    const_iterator begin() const noexcept { return p; }
+    const_iterator end()   const noexcept { return p + n; }
+    bool is_zero() const noexcept { return n == 1 && p[0] == 0; }
+
+private:
+    static const limb_type ZERO;
+
+    const limb_type *p;
+    size_type n;
+}; // class const_view
+
+} // namespace mpn
+
+} // namespace kedixa
+
+#endif // KEDIXA_MPN_H
@@ -0,0 +1,125 @@
+#ifndef KEDIXA_NUMBER_THEORY_H
+#define KEDIXA_NUMBER_THEORY_H
+
+#include "kedixa/bigint.h"
+#include "kedixa/unsigned_bigint.h"
+
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace kedixa {
+
+// the greatest common divisor, gcd(0, 0) = 0
+unsigned_bigint gcd(const unsigned_bigint &a, const unsigned_bigint &b);
+
+// (g, s, t) with g = gcd(|a|, |b|) = s * a + t * b, where |s| <= |b| / g
+// and |t| <= |a| / g unless one of a, b is zero
+std::tuple<bigint, bigint, bigint> gcdext(const bigint &a, const bigint &b);
+
+// floor(sqrt(n)) and floor(n^(1/k)), k > 0
+unsigned_bigint isqrt(const unsigned_bigint &n);
+unsigned_bigint iroot(const unsigned_bigint &n, unsigned k);
+// whether n = x^2, or n = x^k for some k >= 2, 0 and 1 are both
+bool is_square(const unsigned_bigint &n);
+bool is_perfect_power(const unsigned_bigint &n);
+
+// the Baillie-PSW test, that is a strong probable prime test to base 2 and a
+// strong Lucas test, followed by rounds more Miller-Rabin tests with pseudo
+// random bases, no composite number is known to pass BPSW
+bool is_probable_prime(const unsigned_bigint &n, unsigned rounds = 0);
+// the smallest probable prime greater than n
+unsigned_bigint next_prime(const unsigned_bigint &n, unsigned rounds = 0);
+
+// the product of the factors, 1 for none, multiplied in pairs level by level
+// so that the operands of each multiplication have about the same size; the
+// multiplications of a level are shared by threads when they are large
+unsigned_bigint product(std::vector<unsigned_bigint> factors, unsigned threads = 1);
+template<typename InputIt>
+unsigned_bigint product(InputIt first, InputIt last, unsigned threads = 1)
+{ return product(std::vector<unsigned_bigint>(first, last), threads); }
+
+// n! by the prime swing algorithm, and the binomial coefficient C(n, k),
+// which is zero for k > n
+unsigned_bigint factorial(unsigned n, unsigned threads = 1);
+unsigned_bigint binomial(unsigned n, unsigned k, unsigned threads = 1);
+
+namespace _k_help {
+
+// fill (p, n) with uniform limbs from g, one call for a limb or two when g
+// gives all the 32 or 64 bits, and through uniform_int_distribution otherwise
+template<typename URBG>
+void random_limbs(mpn::limb_type *p, mpn::size_type n, URBG &g)
+{
+    using result_type = typename URBG::result_type;
+    const bool bits64 = URBG::min() == 0 && uint64_t(URBG::max()) == UINT64_MAX;
+    const bool bits32 = URBG::min() == 0 && uint64_t(URBG::max()) == UINT32_MAX;
+    mpn::size_type i = 0;
+    if(bits64)
+    {
+        for(; i + 1 < n; i += 2)
+        {
+            uint64_t x = uint64_t(result_type(g()));
+            p[i] = mpn::limb_type(x);
+            p[i+1] = mpn::limb_type(x >> mpn::LIMB_BITS);
+        }
+    }
+    if(bits32 || bits64)
+    {
+        for(; i < n; ++i)
+            p[i] = mpn::limb_type(g());
+    }
+    else
+    {
+        std::uniform_int_distribution<mpn::limb_type> dist;
+        for(; i < n; ++i)
+            p[i] = dist(g);
+    }
+}
+
+} // namespace _k_help
+
+// a uniform random number in [0, 2^bits), its limbs taken straight from g
+template<typename URBG>
+unsigned_bigint random_bits(unsigned_bigint::size_type bits, URBG &g)
+{
+    const mpn::size_type n = (bits + mpn::LIMB_BITS - 1) / mpn::LIMB_BITS;
+    std::vector<mpn::limb_type> limbs(n);
+    _k_help::random_limbs(limbs.data(), n, g);
+    if(bits % mpn::LIMB_BITS)
+        limbs[n-1] &= (mpn::limb_type(1) << (bits % mpn::LIMB_BITS)) - 1;
+    return unsigned_bigint(std::move(limbs));
+}
+
+// a uniform random number in [0, bound), throw std::runtime_error if bound
+// is zero. The top limb is drawn within the bit length of that of bound and
+// redrawn while greater, then the lower limbs are drawn and the whole
+// number is rejected if it is not less than bound, which happens with
+// probability at most 1/2. The lower limbs are drawn on every try, even
+// when the top limb alone decides, so the result is not biased
+template<typename URBG>
+unsigned_bigint random_below(const unsigned_bigint &bound, URBG &g)
+{
+    if(bound.is_zero())
+        throw std::runtime_error("kedixa::random_below: the bound is zero.");
+    mpn::const_view b = bound.view();
+    const mpn::size_type n = b.size();
+    const mpn::limb_type top = b[n-1];
+    const mpn::limb_type mask = mpn::limb_type(-1) >> mpn::clz(top);
+    std::vector<mpn::limb_type> limbs(n);
+    for(;;)
+    {
+        do {
+            _k_help::random_limbs(&limbs[n-1], 1, g);
+            limbs[n-1] &= mask;
+        } while(limbs[n-1] > top);
+        _k_help::random_limbs(limbs.data(), n - 1, g);
+        if(limbs[n-1] < top || mpn::cmp(limbs.data(), b.data(), n) < 0)
+            return unsigned_bigint(std::move(limbs));
+    }
+}
+
+} // namespace kedixa
+
+#endif // KEDIXA_NUMBER_THEORY_H
@@ -0,0 +1,164 @@
+#ifndef KEDIXA_RATIONAL_H
+#define KEDIXA_RATIONAL_H
+
+#include "kedixa/unsigned_bigint.h"
+
+namespace kedixa {
+
+class rational {
+public:
+    using size_type = unsigned_bigint::size_type;
+    using uint_type = unsigned_bigint::uint_type;
+    using int_type  = unsigned_bigint::int_type;
+    using ull_type  = unsigned_bigint::ull_type;
+    using llint_type= unsigned_bigint::llint_type;
+    using ubigint   = unsigned_bigint;
+
+public:
+    // constructors
+    rational(const ubigint &n = ubigint(0u), const ubigint &d = ubigint(1u), bool sign = false);
+    rational(ubigint&&, ubigint&&, bool);
+    rational(const rational&);
+    rational(rational&&);
+
+    // assignment operators
+    rational& operator= (const rational&);
+    rational& operator= (rational&&);
+    rational& operator+=(const rational&);
+    rational& operator-=(const rational&);
+    rational& operator*=(const rational&);
+    rational& operator/=(const rational&);
+
+    // conversion operators
+    explicit operator bool() const noexcept;
+
+    // conversion functions
+    long double to_ld() const;
+    
+    // arithmetic operators
+    friend rational operator+ (const rational&, const rational&);
+    friend rational operator- (const rational&, const rational&);
+    friend rational operator* (const rational&, const rational&);
+    friend rational operator/ (const rational&, const rational&);
+
+    rational operator+ () const;
+    rational operator- () const;
+
+    // relational operators
+    friend bool operator< (const rational&, const rational&);
+    friend bool operator==(const rational&, const rational&) noexcept;
+    friend bool operator<=(const rational&, const rational&);
+    friend bool operator> (const rational&, const rational&);
+    friend bool operator>=(const rational&, const rational&);
+    friend bool operator!=(const rational&, const rational&) noexcept;
+
+    // relational operators with native integers, without a temporary rational
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) != 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) != 0; }
+
+    // others
+    int compare(const rational&) const;
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    int compare(const T number) const noexcept
+    { return this->compare_small(_k_help::abs_of(number), _k_help::is_negative(number)); }
+    bool is_zero() const noexcept;
+    bool is_one()  const noexcept;
+    int  sgn()     const noexcept; // -1, 0 or 1
+
+    rational  add   (const rational&) const;
+    rational& add_eq(const rational&);
+    rational  sub   (const rational&) const;
+    rational& sub_eq(const rational&);
+    rational  multi (const rational&) const;
+    rational& multi_eq(const rational&);
+    rational  div   (const rational&) const;
+    rational& div_eq(const rational&);
+
+    ubigint get_num() const; // return numerator
+    ubigint get_den() const; // return denominator
+    const ubigint& numerator() const noexcept;   // without copying
+    const ubigint& denominator() const noexcept; // without copying
+    bool    get_sign() const; // return sign
+    // reduce the rational to a approximate one, to save space and time,
+    // DON'T use it if you need a exact number.
+    void approximate(size_type hint = 0);
+    void opposite() noexcept;  // *this = -*this
+    void reciprocal(); // *this = this->den/this->num
+    void swap(rational&) noexcept;
+    size_type num_size() const noexcept;
+    size_type den_size() const noexcept;
+    size_type num_capacity() const noexcept;
+    size_type den_capacity() const noexcept;
+    void reserve(size_type num_limbs, size_type den_limbs);
+    void shrink_to_fit();
+    void clear() noexcept; // *this = 0
+    std::string to_string(bool reverse = false) const;
+    std::string to_decimal(size_type decimal_digits = 16, bool reverse = false) const;
+    ~rational() noexcept;
+
+    friend std::hash<rational>;
+
+private:
+    ubigint num; // numerator
+    ubigint den; // denominator
+    bool sign;   // 0 for +, 1 for -
+
+    void reduce(); // reduce the fraction
+    // *this += (rat_sign ? -|rat| : |rat|), reuse the buffers of *this
+    rational& add_eq_signed(const rational &rat, bool rat_sign);
+    // compare with (neg ? -number : number)
+    int compare_small(const ull_type number, bool neg) const noexcept;
+}; // class rational
+
+void swap(rational&, rational&) noexcept;
+
+} // namespace kedixa
+
+namespace std {
+template<> struct hash<kedixa::rational> {
+    // the hash of the numerator seeds that of the denominator, so a/b and
+    // b/a differ
+    size_t operator()(const kedixa::rational &rat) const noexcept {
+        kedixa::mpn::const_view n = rat.num.view(), d = rat.den.view();
+        uint64_t h = kedixa::mpn::hash(n.data(), n.size(), rat.sign);
+        return size_t(kedixa::mpn::hash(d.data(), d.size(), h));
+    }
+};
+
+} // namespace std
+
+#endif // KEDIXA_RATIONAL_H
@@ -0,0 +1,405 @@
+#ifndef KEDIXA_UNSIGNED_BIGINT_H
+#define KEDIXA_UNSIGNED_BIGINT_H
+
+#include "kedixa/limb_vector.h"
+#include "kedixa/mpn.h"
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+namespace kedixa {
+
+namespace _k_help {
+
+template<typename T, unsigned N>
+struct NPOW_OF_TEN
+{ static const T value = NPOW_OF_TEN<T, N-1>::value * 10; };
+
+template<typename T>
+struct NPOW_OF_TEN<T, 0>
+{ static const T value = 1; };
+
+template<typename T>
+using enable_if_integral = typename std::enable_if<std::is_integral<T>::value, int>::type;
+
+template<typename T>
+inline bool is_negative(const T number, std::true_type) noexcept
+{ return number < 0; }
+template<typename T>
+inline bool is_negative(const T, std::false_type) noexcept
+{ return false; }
+template<typename T>
+inline bool is_negative(const T number) noexcept
+{ return is_negative(number, std::is_signed<T>()); }
+
+// absolute value of a native integer, as an uint64_t
+template<typename T>
+inline uint64_t abs_of(const T number) noexcept
+{ return is_negative(number) ? uint64_t(0) - uint64_t(number) : uint64_t(number); }
+
+// r = a + b and r = a * b, return whether they overflow 64 bits
+inline bool add_overflow(uint64_t a, uint64_t b, uint64_t &r) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_add_overflow(a, b, &r);
+#else
+    r = a + b;
+    return r < a;
+#endif
+}
+inline bool mul_overflow(uint64_t a, uint64_t b, uint64_t &r) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_mul_overflow(a, b, &r);
+#else
+    r = a * b;
+    return a != 0 && r / a != b;
+#endif
+}
+
+} // namespace _k_help
+
+class unsigned_bigint {
+    template<typename T>
+    using vector      = std::vector<T>;
+    using limbs       = _k_help::limb_vector;
+    template<typename T, unsigned N>
+    using NPOW_OF_TEN = _k_help::NPOW_OF_TEN<T, N>;
+
+public:
+    using size_type   = size_t;
+    using uint_type   = uint32_t;
+    using int_type    = int32_t;
+    using ull_type    = uint64_t;
+    using llint_type  = int64_t;
+    using const_view  = mpn::const_view;
+
+    static const uint_type UINT_TYPE_MAX = uint_type(-1);
+    static const size_type UINT_LEN      = sizeof(uint_type) * 8;
+    static const size_type SUBSTR_LEN    = UINT_LEN / 4;
+    static const ull_type  TENS_MASK     = NPOW_OF_TEN<ull_type, SUBSTR_LEN>::value;
+
+private:
+    static constexpr double TOSTR_HINT   = 0.302 * UINT_LEN / SUBSTR_LEN; // 0.302 ~= log10(2)
+
+    limbs digits;
+    void strip() noexcept;
+    // whether v may refer to the limbs of *this
+    bool aliases(const_view v) const noexcept;
+    static limbs product(const_view, const_view);
+
+    // take the digits of a result without copying, and strip them
+    unsigned_bigint(limbs&&, bool);
+    unsigned_bigint& rsub_eq(const_view); // *this = v - *this
+    // take the digits of a result, copy them if the current capacity is enough
+    void assign_digits(limbs&&);
+    // *this becomes the remainder, and the quotient is saved to *quot if it
+    // is not nullptr, the divisor has at least two limbs and is not greater
+    // than *this
+    void div_mod_eq(const_view, limbs *quot);
+
+    // in place arithmetic with a 64-bit number, used by bigint
+    unsigned_bigint& add_eq_ull  (const ull_type );
+    unsigned_bigint& sub_eq_ull  (const ull_type );
+    unsigned_bigint& rsub_eq_ull (const ull_type ); // *this = number - *this
+    unsigned_bigint& multi_eq_ull(const ull_type );
+    ull_type         div_eq_ull  (const ull_type ); // return the remainder
+    void assign_ull(const ull_type);
+    int compare_ull(const ull_type) const noexcept;
+
+    // the number fits in a machine word, and is kept in the object by
+    // limb_vector, so the arithmetic of such numbers runs on uint64_t and
+    // falls back to the limbs only on overflow
+    bool is_word() const noexcept { return digits.size() <= 2; }
+    ull_type word() const noexcept {
+        return digits.size() == 2 ? digits[0] | (ull_type(digits[1]) << UINT_LEN)
+                                  : digits.size() ? digits[0] : 0;
+    }
+    static bool is_word(const_view v) noexcept { return v.size() <= 2; }
+    static ull_type word(const_view v) noexcept
+    { return v.size() == 2 ? v[0] | (ull_type(v[1]) << UINT_LEN) : v[0]; }
+
+    friend class bigint;
+    friend class montgomery_context;
+    friend class barrett_context;
+
+public:
+    // constructors
+    explicit
+    unsigned_bigint(const uint_type number = 0 );
+    explicit
+    unsigned_bigint(const vector<uint_type>&   );
+    explicit
+    unsigned_bigint(vector<uint_type>&&        );
+    explicit
+    unsigned_bigint(const std::string&         );
+    explicit
+    unsigned_bigint(const char*                );
+    explicit
+    unsigned_bigint(const_view                 ); // copy the limbs
+    unsigned_bigint(const unsigned_bigint&     );
+    unsigned_bigint(unsigned_bigint&&          );
+
+    // assignment operators
+    unsigned_bigint& operator=  (const unsigned_bigint& );
+    unsigned_bigint& operator=  (unsigned_bigint&&      );
+    unsigned_bigint& operator+= (const uint_type        );
+    unsigned_bigint& operator+= (const unsigned_bigint& );
+    unsigned_bigint& operator+= (const_view             );
+    unsigned_bigint& operator-= (const uint_type        );
+    unsigned_bigint& operator-= (const unsigned_bigint& );
+    unsigned_bigint& operator-= (const_view             );
+    unsigned_bigint& operator*= (const uint_type        );
+    unsigned_bigint& operator*= (const unsigned_bigint& );
+    unsigned_bigint& operator*= (const_view             );
+    unsigned_bigint& operator/= (const uint_type        );
+    unsigned_bigint& operator/= (const unsigned_bigint& );
+    unsigned_bigint& operator/= (const_view             );
+    unsigned_bigint& operator%= (const uint_type        );
+    unsigned_bigint& operator%= (const unsigned_bigint& );
+    unsigned_bigint& operator%= (const_view             );
+    unsigned_bigint& operator&= (const unsigned_bigint& );
+    unsigned_bigint& operator|= (const unsigned_bigint& );
+    unsigned_bigint& operator^= (const unsigned_bigint& );
+    unsigned_bigint& operator<<=(const size_type        );
+    unsigned_bigint& operator>>=(const size_type        );
+
+    // conversion operators
+    explicit operator bool()      const noexcept;
+    explicit operator uint_type() const noexcept;
+    explicit operator ull_type()  const noexcept;
+
+    // conversion functions
+    uint_type to_uint() const;
+    ull_type  to_ull()  const;
+    long double to_ld() const;
+
+    // arithmetic operators
+    friend unsigned_bigint operator+ (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator+ (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator+ (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator+ (unsigned_bigint&&,      unsigned_bigint&&      );
+    friend unsigned_bigint operator+ (const unsigned_bigint&, const uint_type        );
+    friend unsigned_bigint operator+ (const uint_type,        const unsigned_bigint& );
+    friend unsigned_bigint operator+ (unsigned_bigint&&,      const uint_type        );
+    friend unsigned_bigint operator+ (const uint_type,        unsigned_bigint&&      );
+
+    friend unsigned_bigint operator- (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator- (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator- (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator- (unsigned_bigint&&,      unsigned_bigint&&      );
+    friend unsigned_bigint operator- (const unsigned_bigint&, const uint_type        );
+    friend unsigned_bigint operator- (const uint_type,        const unsigned_bigint& );
+    friend unsigned_bigint operator- (unsigned_bigint&&,      const uint_type        );
+    friend unsigned_bigint operator- (const uint_type,        unsigned_bigint&&      );
+
+    friend unsigned_bigint operator* (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator* (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator* (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator* (unsigned_bigint&&,      unsigned_bigint&&      );
+    friend unsigned_bigint operator* (const unsigned_bigint&, const uint_type        );
+    friend unsigned_bigint operator* (const uint_type,        const unsigned_bigint& );
+    friend unsigned_bigint operator* (unsigned_bigint&&,      const uint_type        );
+    friend unsigned_bigint operator* (const uint_type,        unsigned_bigint&&      );
+
+    friend unsigned_bigint operator/ (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator/ (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator/ (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator/ (unsigned_bigint&&,      unsigned_bigint&&      );
+    friend unsigned_bigint operator/ (const unsigned_bigint&, const uint_type        );
+    friend unsigned_bigint operator/ (const uint_type,        const unsigned_bigint& );
+    friend unsigned_bigint operator/ (unsigned_bigint&&,      const uint_type        );
+    friend unsigned_bigint operator/ (const uint_type,        unsigned_bigint&&      );
+
+
+    friend unsigned_bigint operator% (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator% (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator% (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator% (unsigned_bigint&&,      unsigned_bigint&&      );
+    friend unsigned_bigint operator% (const unsigned_bigint&, const uint_type        );
+    friend unsigned_bigint operator% (const uint_type,        const unsigned_bigint& );
+    friend unsigned_bigint operator% (unsigned_bigint&&,      const uint_type        );
+    friend unsigned_bigint operator% (const uint_type,        unsigned_bigint&&      );
+
+    unsigned_bigint& operator++();
+    unsigned_bigint& operator--();
+    unsigned_bigint  operator++(int);
+    unsigned_bigint  operator--(int);
+    unsigned_bigint  operator+ () const;
+    unsigned_bigint  operator- () const = delete;
+
+    // bitwise operators
+    friend unsigned_bigint operator<<(const unsigned_bigint&, size_type              );
+    friend unsigned_bigint operator<<(unsigned_bigint&&,      size_type              );
+    friend unsigned_bigint operator>>(const unsigned_bigint&, size_type              );
+    friend unsigned_bigint operator>>(unsigned_bigint&&,      size_type              );
+    friend unsigned_bigint operator& (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator& (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator& (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator& (unsigned_bigint&&,      unsigned_bigint&&      );
+    friend unsigned_bigint operator| (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator| (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator| (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator| (unsigned_bigint&&,      unsigned_bigint&&      );
+    friend unsigned_bigint operator^ (const unsigned_bigint&, const unsigned_bigint& );
+    friend unsigned_bigint operator^ (const unsigned_bigint&, unsigned_bigint&&      );
+    friend unsigned_bigint operator^ (unsigned_bigint&&,      const unsigned_bigint& );
+    friend unsigned_bigint operator^ (unsigned_bigint&&,      unsigned_bigint&&      );
+
+    // relational operators
+    friend bool operator< (const unsigned_bigint&, const uint_type        ) noexcept;
+    friend bool operator< (const uint_type,        const unsigned_bigint& ) noexcept;
+    friend bool operator< (const unsigned_bigint&, const unsigned_bigint& ) noexcept;
+    friend bool operator==(const unsigned_bigint&, const uint_type        ) noexcept;
+    friend bool operator==(const uint_type,        const unsigned_bigint& ) noexcept;
+    friend bool operator==(const unsigned_bigint&, const unsigned_bigint& ) noexcept;
+    friend bool operator<=(const unsigned_bigint&, const uint_type        ) noexcept;
+    friend bool operator<=(const uint_type,        const unsigned_bigint& ) noexcept;
+    friend bool operator<=(const unsigned_bigint&, const unsigned_bigint& ) noexcept;
+    friend bool operator> (const unsigned_bigint&, const uint_type        ) noexcept;
+    friend bool operator> (const uint_type,        const unsigned_bigint& ) noexcept;
+    friend bool operator> (const unsigned_bigint&, const unsigned_bigint& ) noexcept;
+    friend bool operator>=(const unsigned_bigint&, const uint_type        ) noexcept;
+    friend bool operator>=(const uint_type,        const unsigned_bigint& ) noexcept;
+    friend bool operator>=(const unsigned_bigint&, const unsigned_bigint& ) noexcept;
+    friend bool operator!=(const unsigned_bigint&, const uint_type        ) noexcept;
+    friend bool operator!=(const uint_type,        const unsigned_bigint& ) noexcept;
+    friend bool operator!=(const unsigned_bigint&, const unsigned_bigint& ) noexcept;
+
+    // relational operators with any other native integer, without a
+    // temporary unsigned_bigint
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const unsigned_bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const T lhs, const unsigned_bigint &rhs) noexcept
+    { return rhs.compare(lhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const unsigned_bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const T lhs, const unsigned_bigint &rhs) noexcept
+    { return rhs.compare(lhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const unsigned_bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const T lhs, const unsigned_bigint &rhs) noexcept
+    { return rhs.compare(lhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const unsigned_bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const T lhs, const unsigned_bigint &rhs) noexcept
+    { return rhs.compare(lhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const unsigned_bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const T lhs, const unsigned_bigint &rhs) noexcept
+    { return rhs.compare(lhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const unsigned_bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) != 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const T lhs, const unsigned_bigint &rhs) noexcept
+    { return rhs.compare(lhs) != 0; }
+
+    // others
+    int compare(const unsigned_bigint&) const noexcept;
+    int compare(const_view) const noexcept;
+    // a negative number is less than any unsigned_bigint
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    int compare(const T number) const noexcept
+    { return _k_help::is_negative(number) ? 1 : this->compare_ull(ull_type(number)); }
+    bool is_zero() const noexcept;
+    bool is_one()  const noexcept;
+    int  sgn()     const noexcept; // 0 or 1
+
+    unsigned_bigint  add(const unsigned_bigint&      ) const;
+    unsigned_bigint  add(const uint_type             ) const;
+    unsigned_bigint& add_eq(const unsigned_bigint&   );
+    unsigned_bigint& add_eq(const_view               );
+    unsigned_bigint& add_eq(const uint_type          );
+
+    unsigned_bigint  sub(const unsigned_bigint&      ) const;
+    unsigned_bigint  sub(const uint_type             ) const;
+    unsigned_bigint& sub_eq(const unsigned_bigint&   );
+    unsigned_bigint& sub_eq(const_view               );
+    unsigned_bigint& sub_eq(const uint_type          );
+
+    unsigned_bigint  multi(const unsigned_bigint&    ) const;
+    unsigned_bigint  multi(const uint_type           ) const;
+    unsigned_bigint& multi_eq(const unsigned_bigint& );
+    unsigned_bigint& multi_eq(const_view             );
+    unsigned_bigint& multi_eq(const uint_type        );
+
+    unsigned_bigint  div(const unsigned_bigint&      ) const;
+    unsigned_bigint  div(const uint_type             ) const;
+    unsigned_bigint& div_eq(const unsigned_bigint&   );
+    unsigned_bigint& div_eq(const_view               );
+    unsigned_bigint& div_eq(const uint_type          );
+
+    unsigned_bigint  mod(const unsigned_bigint&      ) const;
+    unsigned_bigint  mod(const uint_type             ) const;
+    unsigned_bigint& mod_eq(const unsigned_bigint&   );
+    unsigned_bigint& mod_eq(const_view               );
+    unsigned_bigint& mod_eq(const uint_type          );
+
+    std::pair<unsigned_bigint, unsigned_bigint> div_mod(const unsigned_bigint&) const;
+    std::pair<unsigned_bigint, unsigned_bigint> div_mod(const uint_type)        const;
+    // (*this)^exp % mod, Montgomery multiplication is used if mod is odd
+    unsigned_bigint powmod(const unsigned_bigint &exp, const unsigned_bigint &mod) const;
+    // x in [0, mod) with (*this) * x % mod == 1, throw std::runtime_error if
+    // it does not exist
+    unsigned_bigint invert(const unsigned_bigint &mod) const;
+
+    // bit k has the value 2^k, the bits above bit_length() - 1 are zero,
+    // bit_length() and count_trailing_zeros() are 0 for 0
+    size_type bit_length() const noexcept;
+    size_type popcount() const noexcept;
+    size_type count_trailing_zeros() const noexcept;
+    bool test_bit(size_type k) const noexcept;
+    unsigned_bigint& set_bit(size_type k);
+    unsigned_bigint& clear_bit(size_type k);
+    unsigned_bigint& flip_bit(size_type k);
+    // *this << k and *this >> k, written to a new number without copying
+    // *this first
+    unsigned_bigint shl(size_type k) const;
+    unsigned_bigint shr(size_type k) const;
+    // the bits [pos, pos + len) as a number, i.e. (*this >> pos) % 2^len
+    unsigned_bigint extract_bits(size_type pos, size_type len) const;
+
+    void swap(unsigned_bigint&) noexcept;
+    const_view view() const noexcept; // valid until *this is changed
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+    void reserve(size_type limbs);
+    void shrink_to_fit();
+    void clear() noexcept;
+    std::string to_string(bool reverse = false) const;
+    ~unsigned_bigint() noexcept;
+
+    friend std::hash<unsigned_bigint>;
+}; // unsigned_bigint
+
+void swap(unsigned_bigint&, unsigned_bigint&) noexcept;
+
+} // namespace kedixa
+
+// specialize std::hash<kedixa::unsigned_bigint>
+namespace std {
+template<> struct hash<kedixa::unsigned_bigint> {
+    size_t operator()(const kedixa::unsigned_bigint &ubigint) const noexcept {
+        kedixa::mpn::const_view v = ubigint.view();
+        return size_t(kedixa::mpn::hash(v.data(), v.size()));
+    }
+};
+
+} // namespace std
+
+#endif // KEDIXA_UNSIGNED_BIGINT_H
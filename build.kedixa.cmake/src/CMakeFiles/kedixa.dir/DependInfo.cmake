@@ -0,0 +1,28 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/bigint.cpp" "src/CMakeFiles/kedixa.dir/bigint.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/bigint.cpp.o.d"
+  "/root/repo/src/limb_vector.cpp" "src/CMakeFiles/kedixa.dir/limb_vector.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/limb_vector.cpp.o.d"
+  "/root/repo/src/modint.cpp" "src/CMakeFiles/kedixa.dir/modint.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/modint.cpp.o.d"
+  "/root/repo/src/modular.cpp" "src/CMakeFiles/kedixa.dir/modular.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/modular.cpp.o.d"
+  "/root/repo/src/mpn.cpp" "src/CMakeFiles/kedixa.dir/mpn.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/mpn.cpp.o.d"
+  "/root/repo/src/mpn_gcd.cpp" "src/CMakeFiles/kedixa.dir/mpn_gcd.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/mpn_gcd.cpp.o.d"
+  "/root/repo/src/number_theory.cpp" "src/CMakeFiles/kedixa.dir/number_theory.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/number_theory.cpp.o.d"
+  "/root/repo/src/rational.cpp" "src/CMakeFiles/kedixa.dir/rational.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/rational.cpp.o.d"
+  "/root/repo/src/rns_int.cpp" "src/CMakeFiles/kedixa.dir/rns_int.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/rns_int.cpp.o.d"
+  "/root/repo/src/unsigned_bigint.cpp" "src/CMakeFiles/kedixa.dir/unsigned_bigint.cpp.o" "gcc" "src/CMakeFiles/kedixa.dir/unsigned_bigint.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
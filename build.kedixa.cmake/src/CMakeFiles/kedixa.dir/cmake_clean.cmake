@@ -0,0 +1,29 @@
+file(REMOVE_RECURSE
+  "../lib/libkedixa.a"
+  "../lib/libkedixa.pdb"
+  "CMakeFiles/kedixa.dir/bigint.cpp.o"
+  "CMakeFiles/kedixa.dir/bigint.cpp.o.d"
+  "CMakeFiles/kedixa.dir/limb_vector.cpp.o"
+  "CMakeFiles/kedixa.dir/limb_vector.cpp.o.d"
+  "CMakeFiles/kedixa.dir/modint.cpp.o"
+  "CMakeFiles/kedixa.dir/modint.cpp.o.d"
+  "CMakeFiles/kedixa.dir/modular.cpp.o"
+  "CMakeFiles/kedixa.dir/modular.cpp.o.d"
+  "CMakeFiles/kedixa.dir/mpn.cpp.o"
+  "CMakeFiles/kedixa.dir/mpn.cpp.o.d"
+  "CMakeFiles/kedixa.dir/mpn_gcd.cpp.o"
+  "CMakeFiles/kedixa.dir/mpn_gcd.cpp.o.d"
+  "CMakeFiles/kedixa.dir/number_theory.cpp.o"
+  "CMakeFiles/kedixa.dir/number_theory.cpp.o.d"
+  "CMakeFiles/kedixa.dir/rational.cpp.o"
+  "CMakeFiles/kedixa.dir/rational.cpp.o.d"
+  "CMakeFiles/kedixa.dir/rns_int.cpp.o"
+  "CMakeFiles/kedixa.dir/rns_int.cpp.o.d"
+  "CMakeFiles/kedixa.dir/unsigned_bigint.cpp.o"
+  "CMakeFiles/kedixa.dir/unsigned_bigint.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kedixa.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_modint.dir/test_modint.cpp.o"
+  "CMakeFiles/test_modint.dir/test_modint.cpp.o.d"
+  "test_modint"
+  "test_modint.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_modint.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_modular.dir/test_modular.cpp.o"
+  "CMakeFiles/test_modular.dir/test_modular.cpp.o.d"
+  "test_modular"
+  "test_modular.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_modular.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_mpn.dir/test_mpn.cpp.o"
+  "CMakeFiles/test_mpn.dir/test_mpn.cpp.o.d"
+  "test_mpn"
+  "test_mpn.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_mpn.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
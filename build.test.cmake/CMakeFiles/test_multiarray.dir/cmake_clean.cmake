@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_multiarray.dir/test_multiarray.cpp.o"
+  "CMakeFiles/test_multiarray.dir/test_multiarray.cpp.o.d"
+  "test_multiarray"
+  "test_multiarray.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_multiarray.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_number_theory.dir/test_number_theory.cpp.o"
+  "CMakeFiles/test_number_theory.dir/test_number_theory.cpp.o.d"
+  "test_number_theory"
+  "test_number_theory.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_number_theory.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_rns_int.dir/test_rns_int.cpp.o"
+  "CMakeFiles/test_rns_int.dir/test_rns_int.cpp.o.d"
+  "test_rns_int"
+  "test_rns_int.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_rns_int.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
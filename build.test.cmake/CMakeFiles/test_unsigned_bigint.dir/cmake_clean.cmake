@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_unsigned_bigint.dir/test_unsigned_bigint.cpp.o"
+  "CMakeFiles/test_unsigned_bigint.dir/test_unsigned_bigint.cpp.o.d"
+  "test_unsigned_bigint"
+  "test_unsigned_bigint.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_unsigned_bigint.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
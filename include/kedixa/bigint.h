@@ -14,8 +14,15 @@ public:
     using llint_type = unsigned_bigint::llint_type;
 
 private:
+    // the sign, 0 for + and 1 for -, is the tag of the limbs of ubig, so a
+    // bigint is as small as an unsigned_bigint
     unsigned_bigint ubig;
-    bool sign;              // 0 for +, 1 for -
+    bool sign() const noexcept { return ubig.digits.tag(); }
+    // zero is never negative, so set the sign after the magnitude
+    void set_sign(bool s) noexcept {
+        const unsigned_bigint::limbs &d = ubig.digits;
+        ubig.digits.set_tag(s && (d.size() > 1 || (d.size() == 1 && d[0] != 0)));
+    }
 
 public:
     // constructors
@@ -42,6 +49,28 @@ public:
     bigint& operator/= (const bigint&  );
     bigint& operator%= (const int_type );
     bigint& operator%= (const bigint&  );
+    bigint& operator&= (const bigint&  );
+    bigint& operator|= (const bigint&  );
+    bigint& operator^= (const bigint&  );
+    bigint& operator<<=(const size_type);
+    bigint& operator>>=(const size_type);
+
+    // assignment operators with any other native integer
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    bigint& operator+= (const T number)
+    { return this->add_eq_small(_k_help::abs_of(number), _k_help::is_negative(number)); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    bigint& operator-= (const T number)
+    { return this->add_eq_small(_k_help::abs_of(number), !_k_help::is_negative(number)); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    bigint& operator*= (const T number)
+    { return this->multi_eq_small(_k_help::abs_of(number), _k_help::is_negative(number)); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    bigint& operator/= (const T number)
+    { return this->div_eq_small(_k_help::abs_of(number), _k_help::is_negative(number)); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    bigint& operator%= (const T number)
+    { return this->mod_eq_small(_k_help::abs_of(number), _k_help::is_negative(number)); }
 
     // conversion operators
     explicit operator bool()            const noexcept;
@@ -57,10 +86,89 @@ public:
 
     // arithmetic operators
     friend bigint operator+ (const bigint&, const bigint&);
+    friend bigint operator+ (const bigint&, bigint&&     );
+    friend bigint operator+ (bigint&&,      const bigint&);
+    friend bigint operator+ (bigint&&,      bigint&&     );
+
     friend bigint operator- (const bigint&, const bigint&);
+    friend bigint operator- (const bigint&, bigint&&     );
+    friend bigint operator- (bigint&&,      const bigint&);
+    friend bigint operator- (bigint&&,      bigint&&     );
+
     friend bigint operator* (const bigint&, const bigint&);
+    friend bigint operator* (const bigint&, bigint&&     );
+    friend bigint operator* (bigint&&,      const bigint&);
+    friend bigint operator* (bigint&&,      bigint&&     );
+
     friend bigint operator/ (const bigint&, const bigint&);
+    friend bigint operator/ (const bigint&, bigint&&     );
+    friend bigint operator/ (bigint&&,      const bigint&);
+    friend bigint operator/ (bigint&&,      bigint&&     );
+
     friend bigint operator% (const bigint&, const bigint&);
+    friend bigint operator% (const bigint&, bigint&&     );
+    friend bigint operator% (bigint&&,      const bigint&);
+    friend bigint operator% (bigint&&,      bigint&&     );
+
+    // arithmetic operators with native integers
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator+ (const bigint &lhs, const T rhs)
+    { bigint tmp(lhs); return std::move(tmp += rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator+ (bigint &&lhs, const T rhs)
+    { return std::move(lhs += rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator+ (const T lhs, const bigint &rhs)
+    { bigint tmp(rhs); return std::move(tmp += lhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator+ (const T lhs, bigint &&rhs)
+    { return std::move(rhs += lhs); }
+
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator- (const bigint &lhs, const T rhs)
+    { bigint tmp(lhs); return std::move(tmp -= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator- (bigint &&lhs, const T rhs)
+    { return std::move(lhs -= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator- (const T lhs, const bigint &rhs)
+    { bigint tmp(rhs); tmp -= lhs; tmp.opposite(); return tmp; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator- (const T lhs, bigint &&rhs)
+    { rhs -= lhs; rhs.opposite(); return std::move(rhs); }
+
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator* (const bigint &lhs, const T rhs)
+    { bigint tmp(lhs); return std::move(tmp *= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator* (bigint &&lhs, const T rhs)
+    { return std::move(lhs *= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator* (const T lhs, const bigint &rhs)
+    { bigint tmp(rhs); return std::move(tmp *= lhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator* (const T lhs, bigint &&rhs)
+    { return std::move(rhs *= lhs); }
+
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator/ (const bigint &lhs, const T rhs)
+    { bigint tmp(lhs); return std::move(tmp /= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator/ (bigint &&lhs, const T rhs)
+    { return std::move(lhs /= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator/ (const T lhs, const bigint &rhs)
+    { bigint tmp; tmp += lhs; return std::move(tmp.div_eq(rhs)); }
+
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator% (const bigint &lhs, const T rhs)
+    { bigint tmp(lhs); return std::move(tmp %= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator% (bigint &&lhs, const T rhs)
+    { return std::move(lhs %= rhs); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bigint operator% (const T lhs, const bigint &rhs)
+    { bigint tmp; tmp += lhs; return std::move(tmp.mod_eq(rhs)); }
 
     bigint& operator++();
     bigint& operator--();
@@ -69,9 +177,14 @@ public:
     bigint  operator+ () const;
     bigint  operator- () const;
 
-    // bitwise operators
+    // bitwise operators, on the infinite two's complement representation
+    // as in GMP and Python, so ~x = -x - 1 and >> rounds toward -infinity
     friend bigint operator<<(const bigint&, size_type);
     friend bigint operator>>(const bigint&, size_type);
+    friend bigint operator& (const bigint&, const bigint&);
+    friend bigint operator| (const bigint&, const bigint&);
+    friend bigint operator^ (const bigint&, const bigint&);
+    bigint operator~ () const;
 
     // relational operators
     friend bool operator< (const bigint&, const bigint&) noexcept;
@@ -81,8 +194,52 @@ public:
     friend bool operator>=(const bigint&, const bigint&) noexcept;
     friend bool operator!=(const bigint&, const bigint&) noexcept;
 
+    // relational operators with native integers, without a temporary bigint
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const T lhs, const bigint &rhs) noexcept
+    { return rhs.compare(lhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const T lhs, const bigint &rhs) noexcept
+    { return rhs.compare(lhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const T lhs, const bigint &rhs) noexcept
+    { return rhs.compare(lhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const T lhs, const bigint &rhs) noexcept
+    { return rhs.compare(lhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const T lhs, const bigint &rhs) noexcept
+    { return rhs.compare(lhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const bigint &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) != 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const T lhs, const bigint &rhs) noexcept
+    { return rhs.compare(lhs) != 0; }
+
     // others
     int compare(const bigint&      ) const noexcept;
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    int compare(const T number) const noexcept
+    { return this->compare_small(_k_help::abs_of(number), _k_help::is_negative(number)); }
+    bool is_zero() const noexcept;
+    bool is_one()  const noexcept;
+    int  sgn()     const noexcept; // -1, 0 or 1
 
     bigint  add   (const bigint&   ) const;
     bigint& add_eq(const bigint&   ) ;
@@ -96,14 +253,65 @@ public:
     bigint& mod_eq(const bigint&   ) ;
 
     std::pair<bigint, bigint> div_mod(const bigint&) const;
+    // the quotient q and the remainder r = *this - q * d, with q rounded
+    // towards negative infinity (fdiv, same as div_mod), towards positive
+    // infinity (cdiv), or such that 0 <= r < |d| (ediv)
+    std::pair<bigint, bigint> fdiv_qr(const bigint &d) const;
+    std::pair<bigint, bigint> cdiv_qr(const bigint &d) const;
+    std::pair<bigint, bigint> ediv_qr(const bigint &d) const;
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    std::pair<bigint, bigint> fdiv_qr(const T d) const
+    { return div_qr_small(_k_help::abs_of(d), _k_help::is_negative(d), rounding::floor); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    std::pair<bigint, bigint> cdiv_qr(const T d) const
+    { return div_qr_small(_k_help::abs_of(d), _k_help::is_negative(d), rounding::ceil); }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    std::pair<bigint, bigint> ediv_qr(const T d) const
+    { return div_qr_small(_k_help::abs_of(d), _k_help::is_negative(d), rounding::euclid); }
+    // the remainder of fdiv_qr, same as mod
+    bigint fmod(const bigint &d) const;
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    bigint fmod(const T d) const
+    { bigint tmp(*this); return std::move(tmp.mod_eq_small(_k_help::abs_of(d), _k_help::is_negative(d))); }
+    // (*this)^exp mod mod, exp >= 0, the result has the sign of mod as div_mod
+    bigint powmod(const bigint &exp, const bigint &mod) const;
 
     void opposite()        noexcept; // *this = - *this;
     void swap(bigint &)    noexcept;
     size_type size() const noexcept;
+    size_type capacity() const noexcept;
+    void reserve(size_type limbs);
+    void shrink_to_fit();
+    void clear() noexcept;
     std::string to_string(bool reverse = false) const;
     ~bigint()              noexcept;
 
     friend std::hash<bigint>;
+
+private:
+    enum class rounding { floor, ceil, euclid };
+
+    // *this op= (neg ? -number : number), work on the magnitude in place
+    bigint& add_eq_small  (const ull_type, bool neg);
+    bigint& multi_eq_small(const ull_type, bool neg);
+    bigint& div_eq_small  (const ull_type, bool neg);
+    bigint& mod_eq_small  (const ull_type, bool neg);
+    int     compare_small (const ull_type, bool neg) const noexcept;
+    // a + (b_sign ? -|b| : |b|) and the same in place, the magnitudes are
+    // compared at most once and subtracted directly
+    static bigint add_signed(const bigint &a, const bigint &b, bool b_sign);
+    bigint& add_eq_signed(const bigint &big, bool big_sign);
+    // the magnitude fits in a machine word, see unsigned_bigint::is_word
+    bool is_word() const noexcept { return ubig.is_word(); }
+    ull_type word() const noexcept { return ubig.word(); }
+    void set_word(const ull_type magnitude, bool neg);
+    // the division of fdiv_qr, cdiv_qr and ediv_qr by (d_sign ? -|d| : |d|),
+    // the rounding is fixed up on the magnitudes of the truncated result
+    static std::pair<bigint, bigint>
+    div_qr(const bigint &n, mpn::const_view d, bool d_sign, rounding mode);
+    std::pair<bigint, bigint> div_qr_small(const ull_type d, bool neg, rounding mode) const;
+    // a & b, a | b or a ^ b for op '&', '|' or '^'
+    static bigint bitwise(const bigint &a, const bigint &b, char op);
 }; // class bigint
 
 void swap(bigint&, bigint&) noexcept;
@@ -113,12 +321,9 @@ void swap(bigint&, bigint&) noexcept;
 // specialize std::hash<kedixa::bigint>
 namespace std {
 template<> struct hash<kedixa::bigint> {
-    size_t operator()(const kedixa::bigint &big) const {
-        size_t hash_code = hash<kedixa::unsigned_bigint>()(big.ubig);
-        if(big.sign)
-            hash_code = (~hash_code + 1);
-
-        return hash_code;
+    size_t operator()(const kedixa::bigint &big) const noexcept {
+        kedixa::mpn::const_view v = big.ubig.view();
+        return size_t(kedixa::mpn::hash(v.data(), v.size(), big.sign()));
     }
 };
 
@@ -0,0 +1,179 @@
+#ifndef KEDIXA_LIMB_VECTOR_H
+#define KEDIXA_LIMB_VECTOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace kedixa {
+
+namespace _k_help {
+
+// The digits (limbs) of a big number, a subset of std::vector<uint32_t>.
+//
+// Up to INLINE_CAP limbs, i.e. any number below 2^64, are kept in the
+// object itself in place of the buffer pointer, so small numbers never
+// touch the heap. A vector moves to the heap when it grows beyond that,
+// and back only on shrink_to_fit.
+//
+// Copies of a large vector share one reference counted buffer, and the
+// buffer is duplicated when one of them is about to be written (copy on
+// write), so passing large numbers by value costs O(1). Small vectors
+// and vectors with much unused capacity (e.g. a reserved accumulator)
+// are always copied deeply.
+//
+// Every non-const member function, including operator[], data() and
+// begin(), makes the buffer unshared before returning. The limbs kept in
+// the object move with it, so pointers into a small vector are
+// invalidated by moves and swaps too.
+//
+// The high bit of the size is a tag for the owner, e.g. the sign of a
+// bigint, so that it costs no extra word. The tag belongs to the object,
+// not to the limbs: copies and moves start untagged, and assignments and
+// swaps of the limbs leave it alone.
+class limb_vector {
+public:
+    using value_type             = uint32_t;
+    using size_type              = size_t;
+    using iterator               = value_type*;
+    using const_iterator         = const value_type*;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // vectors with at least SHARE_HINT limbs are shared by copies
+    static const size_type SHARE_HINT = 64;
+    // vectors of at most INLINE_CAP limbs are kept in the object
+    static const size_type INLINE_CAP = 2;
+
+    limb_vector() noexcept : n(INLINE) { u.p = nullptr; }
+    explicit
+    limb_vector(size_type count, value_type value = 0);
+    explicit
+    limb_vector(const std::vector<value_type>&);
+    limb_vector(const limb_vector&);
+    limb_vector(limb_vector &&lv) noexcept : u(lv.u), n(lv.n & ~TAG)
+    { lv.u.p = nullptr, lv.n = (lv.n & TAG) | INLINE; }
+    ~limb_vector() noexcept
+    { if(!is_inline()) release(u.p); }
+
+    limb_vector& operator=(const limb_vector&);
+    limb_vector& operator=(limb_vector &&lv) noexcept
+    { this->swap(lv); return *this; }
+
+    // element access
+    const value_type& operator[](size_type i) const noexcept { return buf()[i]; }
+    value_type& operator[](size_type i) { unshare(); return buf()[i]; }
+    const value_type& back() const noexcept { return buf()[len()-1]; }
+    value_type& back() { unshare(); return buf()[len()-1]; }
+    const value_type* data() const noexcept { return buf(); }
+    value_type* data() { unshare(); return buf(); }
+
+    // iterators
+    const_iterator begin()  const noexcept { return buf(); }
+    const_iterator end()    const noexcept { return buf() + len(); }
+    const_iterator cbegin() const noexcept { return buf(); }
+    const_iterator cend()   const noexcept { return buf() + len(); }
+    iterator begin() { unshare(); return buf(); }
+    iterator end()   { unshare(); return buf() + len(); }
+    const_reverse_iterator crbegin() const noexcept
+    { return const_reverse_iterator(cend()); }
+    const_reverse_iterator crend() const noexcept
+    { return const_reverse_iterator(cbegin()); }
+
+    // capacity
+    bool empty() const noexcept { return len() == 0; }
+    size_type size() const noexcept { return len(); }
+    size_type capacity() const noexcept
+    { return is_inline() ? INLINE_CAP : head()->cap; }
+    bool shared() const noexcept
+    { return !is_inline() && head()->refs.load(std::memory_order_acquire) > 1; }
+    void reserve(size_type);
+    void shrink_to_fit();
+
+    // modifiers
+    void assign(size_type count, value_type value);
+    template<typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        size_type count = std::distance(first, last);
+        prepare(count, false);
+        value_type *p = buf();
+        for(size_type i = 0; first != last; ++first, ++i)
+            p[i] = *first;
+        set_len(count);
+    }
+    void resize(size_type count, value_type value = 0)
+    {
+        // shrinking does not write to the buffer, so a shared one is kept
+        size_type l = len();
+        if(count > l)
+        {
+            if(count > capacity() || shared()) prepare(count, true);
+            value_type *p = buf();
+            for(size_type i = l; i < count; ++i) p[i] = value;
+        }
+        set_len(count);
+    }
+    void push_back(value_type value);
+    iterator insert(const_iterator pos, size_type count, value_type value);
+    iterator erase(const_iterator first, const_iterator last);
+    void clear() noexcept;
+    void swap(limb_vector &lv) noexcept
+    {
+        const size_type keep = n & TAG, lv_keep = lv.n & TAG;
+        std::swap(u, lv.u), std::swap(n, lv.n);
+        n = (n & ~TAG) | keep, lv.n = (lv.n & ~TAG) | lv_keep;
+    }
+
+    // the tag of the owner
+    bool tag() const noexcept { return n & TAG; }
+    void set_tag(bool t) noexcept { n = t ? (n | TAG) : (n & ~TAG); }
+
+    std::vector<value_type> to_vector() const
+    { return std::vector<value_type>(begin(), end()); }
+
+private:
+    struct header {
+        std::atomic<size_type> refs;
+        size_type cap;
+    };
+
+    static const size_type TAG    = ~(~size_type(0) >> 1);
+    static const size_type INLINE = TAG >> 1;
+
+    union storage {
+        value_type *p;             // limbs, preceded by a header in the same allocation
+        value_type small[INLINE_CAP];
+    } u;
+    size_type n;   // the size, the tag in the high bit and INLINE below it
+
+    bool is_inline() const noexcept { return n & INLINE; }
+    size_type len() const noexcept { return n & ~(TAG | INLINE); }
+    void set_len(size_type count) noexcept { n = (n & (TAG | INLINE)) | count; }
+    value_type* buf() noexcept { return is_inline() ? u.small : u.p; }
+    const value_type* buf() const noexcept { return is_inline() ? u.small : u.p; }
+
+    header* head() const noexcept
+    { return reinterpret_cast<header*>(u.p) - 1; }
+    void unshare()
+    { if(shared()) reallocate(head()->cap); }
+
+    static value_type* allocate(size_type cap);
+    static void release(value_type*) noexcept;
+    // move the first n limbs to a new unshared buffer with capacity cap, or
+    // into the object if cap <= INLINE_CAP
+    void reallocate(size_type cap);
+    // make sure the buffer is unshared and can hold count limbs,
+    // keep the old limbs only if keep is true
+    void prepare(size_type count, bool keep);
+}; // class limb_vector
+
+inline void swap(limb_vector &lhs, limb_vector &rhs) noexcept
+{ lhs.swap(rhs); }
+
+} // namespace _k_help
+
+} // namespace kedixa
+
+#endif // KEDIXA_LIMB_VECTOR_H
@@ -52,8 +52,52 @@ public:
     friend bool operator>=(const rational&, const rational&);
     friend bool operator!=(const rational&, const rational&) noexcept;
 
+    // relational operators with native integers, without a temporary rational
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator< (const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator==(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) == 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator<=(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) > 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator> (const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) < 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) >= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator>=(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) <= 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const rational &lhs, const T rhs) noexcept
+    { return lhs.compare(rhs) != 0; }
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    friend bool operator!=(const T lhs, const rational &rhs) noexcept
+    { return rhs.compare(lhs) != 0; }
+
     // others
     int compare(const rational&) const;
+    template<typename T, _k_help::enable_if_integral<T> = 0>
+    int compare(const T number) const noexcept
+    { return this->compare_small(_k_help::abs_of(number), _k_help::is_negative(number)); }
+    bool is_zero() const noexcept;
+    bool is_one()  const noexcept;
+    int  sgn()     const noexcept; // -1, 0 or 1
 
     rational  add   (const rational&) const;
     rational& add_eq(const rational&);
@@ -66,6 +110,8 @@ public:
 
     ubigint get_num() const; // return numerator
     ubigint get_den() const; // return denominator
+    const ubigint& numerator() const noexcept;   // without copying
+    const ubigint& denominator() const noexcept; // without copying
     bool    get_sign() const; // return sign
     // reduce the rational to a approximate one, to save space and time,
     // DON'T use it if you need a exact number.
@@ -75,6 +121,11 @@ public:
     void swap(rational&) noexcept;
     size_type num_size() const noexcept;
     size_type den_size() const noexcept;
+    size_type num_capacity() const noexcept;
+    size_type den_capacity() const noexcept;
+    void reserve(size_type num_limbs, size_type den_limbs);
+    void shrink_to_fit();
+    void clear() noexcept; // *this = 0
     std::string to_string(bool reverse = false) const;
     std::string to_decimal(size_type decimal_digits = 16, bool reverse = false) const;
     ~rational() noexcept;
@@ -86,8 +137,11 @@ private:
     ubigint den; // denominator
     bool sign;   // 0 for +, 1 for -
 
-    static ubigint gcd(ubigint x, ubigint y);
     void reduce(); // reduce the fraction
+    // *this += (rat_sign ? -|rat| : |rat|), reuse the buffers of *this
+    rational& add_eq_signed(const rational &rat, bool rat_sign);
+    // compare with (neg ? -number : number)
+    int compare_small(const ull_type number, bool neg) const noexcept;
 }; // class rational
 
 void swap(rational&, rational&) noexcept;
@@ -96,13 +150,12 @@ void swap(rational&, rational&) noexcept;
 
 namespace std {
 template<> struct hash<kedixa::rational> {
-    size_t operator()(const kedixa::rational &rat) const {
-        auto h = hash<kedixa::unsigned_bigint>();
-        size_t hash_code = h(rat.num) ^ h(rat.den);
-        if(rat.sign)
-            hash_code = (~hash_code +  1);
-
-        return hash_code;
+    // the hash of the numerator seeds that of the denominator, so a/b and
+    // b/a differ
+    size_t operator()(const kedixa::rational &rat) const noexcept {
+        kedixa::mpn::const_view n = rat.num.view(), d = rat.den.view();
+        uint64_t h = kedixa::mpn::hash(n.data(), n.size(), rat.sign);
+        return size_t(kedixa::mpn::hash(d.data(), d.size(), h));
     }
 };
 
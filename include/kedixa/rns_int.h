@@ -0,0 +1,115 @@
+#ifndef KEDIXA_RNS_INT_H
+#define KEDIXA_RNS_INT_H
+
+#include "kedixa/modular.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kedixa {
+
+// The moduli of a residue number system, pairwise coprime numbers in
+// (2^30, 2^31), with their floating point reciprocals for the products,
+// and the remainder tree of them for the conversions.
+//
+// The remainder tree holds scratch space, so the conversions of one context
+// must be done by one thread at a time, like the contexts of modular.h.
+class rns_context {
+public:
+    using size_type = unsigned_bigint::size_type;
+    using uint_type = unsigned_bigint::uint_type;
+    using ubigint   = unsigned_bigint;
+
+public:
+    // throw std::runtime_error if the moduli are empty, out of range or
+    // not pairwise coprime
+    explicit rns_context(const std::vector<uint_type> &moduli);
+
+    const std::vector<uint_type>& moduli() const noexcept { return tree.moduli(); }
+    size_type size() const noexcept { return tree.moduli().size(); }
+    // the product M of the moduli
+    const ubigint& product() const noexcept { return tree.product(); }
+
+    // the residues of x, and the number in [0, M) of the residues
+    std::vector<uint_type> to_rns(const ubigint &x) const;
+    ubigint from_rns(const std::vector<uint_type> &rs) const;
+
+private:
+    multi_mod_context tree;
+    std::vector<double> pinv;   // 1.0 / m_i
+
+    friend class rns_int;
+}; // class rns_context
+
+// An integer modulo the product M of the moduli of a rns_context, kept as its
+// residues modulo each of them. An addition, a subtraction or a
+// multiplication works on each residue independently, in one pass of
+// single word operations without carries, and only the conversion back to
+// unsigned_bigint needs the Chinese remainder theorem. The results of a
+// chain of operations are right as long as they stay below M, so the
+// context should be made for a bound of the final size.
+class rns_int {
+public:
+    using size_type   = unsigned_bigint::size_type;
+    using uint_type   = unsigned_bigint::uint_type;
+    using ubigint     = unsigned_bigint;
+    using context_ptr = std::shared_ptr<const rns_context>;
+
+public:
+    // constructors, value is reduced modulo M
+    rns_int(const context_ptr &ctx, const ubigint &value = ubigint(0u));
+    rns_int(const context_ptr &ctx, const uint_type value);
+    rns_int(const rns_int&) = default;
+    rns_int(rns_int&&) = default;
+
+    // a context of the largest primes below 2^31 with M > 2^bits, or of
+    // the given moduli
+    static context_ptr make_context(size_type bits);
+    static context_ptr make_context(const std::vector<uint_type> &moduli);
+
+    // assignment operators, both sides must have the same moduli
+    rns_int& operator= (const rns_int&) = default;
+    rns_int& operator= (rns_int&&) = default;
+    rns_int& operator+=(const rns_int&);
+    rns_int& operator-=(const rns_int&);
+    rns_int& operator*=(const rns_int&);
+
+    // arithmetic operators
+    friend rns_int operator+ (const rns_int &lhs, const rns_int &rhs)
+    { rns_int tmp(lhs); return std::move(tmp += rhs); }
+    friend rns_int operator- (const rns_int &lhs, const rns_int &rhs)
+    { rns_int tmp(lhs); return std::move(tmp -= rhs); }
+    friend rns_int operator* (const rns_int &lhs, const rns_int &rhs)
+    { rns_int tmp(lhs); return std::move(tmp *= rhs); }
+    rns_int operator- () const;
+
+    // relational operators
+    friend bool operator==(const rns_int &lhs, const rns_int &rhs) noexcept
+    { return lhs.ctx->moduli() == rhs.ctx->moduli() && lhs.rs == rhs.rs; }
+    friend bool operator!=(const rns_int &lhs, const rns_int &rhs) noexcept
+    { return !(lhs == rhs); }
+
+    // others
+    const context_ptr& context() const noexcept { return ctx; }
+    const ubigint& modulus() const noexcept { return ctx->product(); }
+    // the residue modulo each modulus
+    const std::vector<uint_type>& residues() const noexcept { return rs; }
+    // the value in [0, M)
+    ubigint value() const { return ctx->from_rns(rs); }
+    bool is_zero() const noexcept;
+    std::string to_string() const { return value().to_string(); }
+    void swap(rns_int &) noexcept;
+
+private:
+    void check_context(const rns_int &) const;
+
+    context_ptr ctx;
+    std::vector<uint_type> rs;
+}; // class rns_int
+
+void swap(rns_int&, rns_int&) noexcept;
+
+} // namespace kedixa
+
+#endif // KEDIXA_RNS_INT_H
@@ -1,26 +1,62 @@
 #include "kedixa/bigint.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
 namespace kedixa {
 
-// constructors
-bigint::bigint(const int_type number)
+namespace {
+
+// the limbs of the two's complement of (p, n), negated if neg, from the
+// lowest one, -m is computed as ~m + 1 on the fly
+struct twos_complement {
+    const uint32_t *p;
+    size_t n;
+    bool neg;
+    uint32_t carry;
+
+    twos_complement(const uint32_t *p, size_t n, bool neg) noexcept
+        : p(p), n(n), neg(neg), carry(1)
+    { }
+    uint32_t apply(uint32_t x) noexcept
+    {
+        if(!neg) return x;
+        x = ~x + carry;
+        carry = carry && x == 0;
+        return x;
+    }
+    uint32_t operator()(size_t i) noexcept
+    { return apply(i < n ? p[i] : 0); }
+};
+
+// (rp, rn) = |a op b| in one pass, rn is one more than the longer operand
+// so that the sign extension fits, return whether a op b is negative
+template<typename Op>
+bool bitwise_limbs(uint32_t *rp, size_t rn, twos_complement a, twos_complement b,
+                   Op op) noexcept
 {
-    llint_type num = number;
-    sign = (number < 0);
-    ubig = unsigned_bigint(sign ? uint_type(-num) : uint_type(num));
+    twos_complement r(nullptr, 0, op(a.neg ? ~0u : 0u, b.neg ? ~0u : 0u) != 0);
+    for(size_t i = 0; i < rn; ++i)
+        rp[i] = r.apply(op(a(i), b(i)));
+    return r.neg;
 }
+
+} // namespace
+
+// constructors
+bigint::bigint(const int_type number)
+    : ubig(uint_type(_k_help::abs_of(number)))
+{ this->set_sign(number < 0); }
 bigint::bigint(const unsigned_bigint &ubig, bool sign)
 {
     this->ubig = ubig;
-    this->sign = sign;
+    this->set_sign(sign);
 }
 bigint::bigint(unsigned_bigint &&ubig, bool sign)
 {
     this->ubig = std::move(ubig);
-    this->sign = sign;
+    this->set_sign(sign);
 }
 bigint::bigint(const std::string &str)
 {
@@ -28,30 +64,32 @@ bigint::bigint(const std::string &str)
     if(len == 0)
     {
         ubig = unsigned_bigint(0u);
-        sign = false;
+        this->set_sign(false);
     }
     else if(str[0] == '+' || str[0] == '-')
     {
         ubig = unsigned_bigint(str.substr(1, len - 1));
-        sign = (str[0] == '-');
+        this->set_sign(str[0] == '-');
     }
     else
     {
         ubig = unsigned_bigint(str);
-        sign = false;
+        this->set_sign(false);
     }
 }
 bigint::bigint(const char *ch)
     : bigint(std::string(ch)) {}
 bigint::bigint(const bigint &big)
 {
-    this->sign = big.sign;
     this->ubig = big.ubig;
+    this->set_sign(big.sign());
 }
 bigint::bigint(bigint &&big)
 {
-    this->sign = big.sign;
+    bool s = big.sign();
     this->ubig = std::move(big.ubig);
+    this->set_sign(s);
+    big.set_sign(false);
 }
 
 // assignment operators
@@ -59,8 +97,8 @@ bigint& bigint::operator=(const bigint &big)
 {
     if(this != &big)
     {
-        this->sign = big.sign;
         this->ubig = big.ubig;
+        this->set_sign(big.sign());
     }
     return *this;
 }
@@ -68,47 +106,68 @@ bigint& bigint::operator=(bigint &&big)
 {
     if(this != &big)
     {
-        this->sign = big.sign;
+        bool s = big.sign();
         this->ubig = std::move(big.ubig);
+        this->set_sign(s);
     }
     return *this;
 }
 bigint& bigint::operator+=(const int_type number)
-{ return this->add_eq(number); }
+{ return this->add_eq_small(_k_help::abs_of(number), number < 0); }
 bigint& bigint::operator+=(const bigint &big)
 { return this->add_eq(big); }
 bigint& bigint::operator-=(const int_type number)
-{ return this->sub_eq(number); }
+{ return this->add_eq_small(_k_help::abs_of(number), number >= 0); }
 bigint& bigint::operator-=(const bigint &big)
 { return this->sub_eq(big); }
 bigint& bigint::operator*=(const int_type number)
-{ return this->multi_eq(number); }
+{ return this->multi_eq_small(_k_help::abs_of(number), number < 0); }
 bigint& bigint::operator*=(const bigint &big)
 { return this->multi_eq(big); }
 bigint& bigint::operator/=(const int_type number)
-{ return this->div_eq(number); }
+{ return this->div_eq_small(_k_help::abs_of(number), number < 0); }
 bigint& bigint::operator/=(const bigint &big)
 { return this->div_eq(big); }
 bigint& bigint::operator%=(const int_type number)
-{ return this->mod_eq(number); }
+{ return this->mod_eq_small(_k_help::abs_of(number), number < 0); }
 bigint& bigint::operator%=(const bigint &big)
 { return this->mod_eq(big); }
+bigint& bigint::operator&=(const bigint &big)
+{ return *this = bitwise(*this, big, '&'); }
+bigint& bigint::operator|=(const bigint &big)
+{ return *this = bitwise(*this, big, '|'); }
+bigint& bigint::operator^=(const bigint &big)
+{ return *this = bitwise(*this, big, '^'); }
+bigint& bigint::operator<<=(const size_type sz)
+{
+    this->ubig <<= sz;
+    return *this;
+}
+bigint& bigint::operator>>=(const size_type sz)
+{
+    // floor(-m / 2^sz) = -ceil(m / 2^sz), which is one more in magnitude
+    // than m >> sz if any bit shifted out is set
+    bool inexact = this->sign() && this->ubig.count_trailing_zeros() < sz;
+    this->ubig >>= sz;
+    if(inexact) ++this->ubig;
+    return *this;
+}
 
 // conversion operators
 bigint::operator bool() const noexcept
-{ return *this != 0; }
+{ return !this->ubig.is_zero(); }
 bigint::operator int_type() const noexcept
 {
     auto i = static_cast<unsigned_bigint::uint_type>(this->ubig);
     int_type result = static_cast<int_type>(i);
-    if(this->sign) return -result;
+    if(this->sign()) return -result;
     else return result;
 }
 bigint::operator llint_type() const noexcept
 {
     auto i = static_cast<unsigned_bigint::ull_type>(this->ubig);
     llint_type result = static_cast<llint_type>(i);
-    if(this->sign) return -result;
+    if(this->sign()) return -result;
     else return result;
 }
 bigint::operator unsigned_bigint() const noexcept
@@ -134,7 +193,7 @@ bigint::llint_type bigint::to_ll() const
 long double bigint::to_ld() const
 {
     auto d = this->ubig.to_ld();
-    if(this->sign) return -d;
+    if(this->sign()) return -d;
     else return d;
 }
 unsigned_bigint bigint::to_ubigint() const
@@ -143,31 +202,58 @@ unsigned_bigint bigint::to_ubigint() const
 // arithmetic operators
 bigint operator+(const bigint &lhs, const bigint &rhs)
 { return std::move(lhs.add(rhs)); }
+bigint operator+(const bigint &lhs, bigint &&rhs)
+{ return std::move(rhs.add_eq(lhs)); }
+bigint operator+(bigint &&lhs, const bigint &rhs)
+{ return std::move(lhs.add_eq(rhs)); }
+bigint operator+(bigint &&lhs, bigint &&rhs)
+{ return std::move(lhs.add_eq(rhs)); }
+
 bigint operator-(const bigint &lhs, const bigint &rhs)
 { return std::move(lhs.sub(rhs)); }
+bigint operator-(const bigint &lhs, bigint &&rhs)
+{
+    // lhs - rhs = -(rhs - lhs)
+    rhs.sub_eq(lhs);
+    rhs.opposite();
+    return std::move(rhs);
+}
+bigint operator-(bigint &&lhs, const bigint &rhs)
+{ return std::move(lhs.sub_eq(rhs)); }
+bigint operator-(bigint &&lhs, bigint &&rhs)
+{ return std::move(lhs.sub_eq(rhs)); }
+
 bigint operator*(const bigint &lhs, const bigint &rhs)
 { return std::move(lhs.multi(rhs)); }
+bigint operator*(const bigint &lhs, bigint &&rhs)
+{ return std::move(rhs.multi_eq(lhs)); }
+bigint operator*(bigint &&lhs, const bigint &rhs)
+{ return std::move(lhs.multi_eq(rhs)); }
+bigint operator*(bigint &&lhs, bigint &&rhs)
+{ return std::move(lhs.multi_eq(rhs)); }
+
 bigint operator/(const bigint &lhs, const bigint &rhs)
 { return std::move(lhs.div(rhs)); }
+bigint operator/(const bigint &lhs, bigint &&rhs)
+{ return std::move(lhs.div(rhs)); }
+bigint operator/(bigint &&lhs, const bigint &rhs)
+{ return std::move(lhs.div_eq(rhs)); }
+bigint operator/(bigint &&lhs, bigint &&rhs)
+{ return std::move(lhs.div_eq(rhs)); }
+
 bigint operator%(const bigint &lhs, const bigint &rhs)
 { return std::move(lhs.mod(rhs)); }
+bigint operator%(const bigint &lhs, bigint &&rhs)
+{ return std::move(lhs.mod(rhs)); }
+bigint operator%(bigint &&lhs, const bigint &rhs)
+{ return std::move(lhs.mod_eq(rhs)); }
+bigint operator%(bigint &&lhs, bigint &&rhs)
+{ return std::move(lhs.mod_eq(rhs)); }
 
 bigint& bigint::operator++()
-{
-    int cmp = this->compare(bigint(-1));
-    if(cmp < 0) --this->ubig;
-    else if(cmp > 0) ++this->ubig;
-    else *this = bigint(0);
-    return *this;
-}
+{ return this->add_eq_small(1, false); }
 bigint& bigint::operator--()
-{
-    int cmp = this->compare(bigint(0));
-    if(cmp > 0) --this->ubig;
-    else if(cmp < 0) ++this->ubig;
-    else *this = bigint(-1);
-    return *this;
-}
+{ return this->add_eq_small(1, true); }
 bigint bigint::operator++(int)
 {
     bigint tmp = *this;
@@ -191,29 +277,33 @@ bigint bigint::operator- () const
 
 // bitwise operators
 bigint operator<<(const bigint &big, bigint::size_type sz)
+{ return bigint(big.ubig.shl(sz), big.sign()); }
+bigint operator>>(const bigint &big, bigint::size_type sz)
 {
-    bigint tmp = big;
-    tmp.ubig <<= sz;
-    return std::move(tmp);
+    // for example, -9 >> 2 = -3, -8 >> 2 = -2, a zero magnitude is never
+    // negative
+    bool neg = big.sign() && !big.ubig.is_zero();
+    bool inexact = neg && big.ubig.count_trailing_zeros() < sz;
+    bigint tmp(big.ubig.shr(sz), false);
+    if(inexact) ++tmp.ubig;
+    tmp.set_sign(neg);
+    return tmp;
 }
-bigint operator>>(const bigint &big, bigint::size_type sz)
+bigint operator& (const bigint &lhs, const bigint &rhs)
+{ return bigint::bitwise(lhs, rhs, '&'); }
+bigint operator| (const bigint &lhs, const bigint &rhs)
+{ return bigint::bitwise(lhs, rhs, '|'); }
+bigint operator^ (const bigint &lhs, const bigint &rhs)
+{ return bigint::bitwise(lhs, rhs, '^'); }
+bigint bigint::operator~ () const
 {
-    if(sz == 0) return big;
-    bigint tmp = big;
-    if(tmp.sign == false)
-        tmp.ubig >>= sz;
-    // right shift for negative number
-    else if(tmp.sign == true)
-    {
-        auto x = (unsigned_bigint(1u) << sz) - 1;
-        x &= tmp.ubig; // lower sz bits of tmp.ubig
-        tmp.ubig >>= sz;
-        // if x is not 0, the answer should add by 1
-        // for example, -9 >> 2 = -3, -8 >> 2 = -2
-        if(x != unsigned_bigint(0u))
-            ++tmp.ubig;
-    }
-    return std::move(tmp);
+    // ~x = -x - 1, that is -(m + 1) for x = m >= 0 and m - 1 for x = -m < 0
+    bool neg = this->sign() && !this->ubig.is_zero();
+    bigint tmp(*this);
+    if(neg) --tmp.ubig;
+    else ++tmp.ubig;
+    tmp.set_sign(!neg);
+    return tmp;
 }
 
 // relational operators
@@ -233,144 +323,375 @@ bool operator!=(const bigint &lhs, const bigint &rhs) noexcept
 // others
 int bigint::compare(const bigint &big) const noexcept
 {
-    if(this->sign == big.sign)
+    if(this->sign() == big.sign())
     {
         int cmp = this->ubig.compare(big.ubig);
-        if(this->sign == 0) return cmp;
+        if(this->sign() == 0) return cmp;
         else return -cmp;
     }
-    else if(this->sign == 0) return 1;
+    else if(this->sign() == 0) return 1;
     else return -1;
 }
+bool bigint::is_zero() const noexcept
+{ return this->ubig.is_zero(); }
+bool bigint::is_one() const noexcept
+{ return !this->sign() && this->ubig.is_one(); }
+int bigint::sgn() const noexcept
+{ return this->sign() ? -1 : this->ubig.sgn(); }
 
 bigint bigint::add(const bigint &big) const
+{ return add_signed(*this, big, big.sign()); }
+bigint& bigint::add_eq(const bigint &big)
+{ return this->add_eq_signed(big, big.sign()); }
+bigint bigint::sub(const bigint &big) const
+{ return add_signed(*this, big, !big.sign()); }
+bigint& bigint::sub_eq(const bigint &big)
+{ return this->add_eq_signed(big, !big.sign()); }
+bigint bigint::multi(const bigint &big) const
 {
     bigint result;
-    if(this->sign == big.sign)
-        result = bigint(this->ubig + big.ubig, this->sign);
+    ull_type r;
+    if(this->is_word() && big.is_word() && !_k_help::mul_overflow(this->word(), big.word(), r))
+        result.set_word(r, this->sign() != big.sign());
+    else if(!this->ubig.is_zero() && !big.ubig.is_zero())
+        result = bigint(this->ubig * big.ubig, this->sign() != big.sign());
+    return result;
+}
+bigint& bigint::multi_eq(const bigint &big)
+{
+    ull_type r;
+    if(this->is_word() && big.is_word() && !_k_help::mul_overflow(this->word(), big.word(), r))
+        this->set_word(r, this->sign() != big.sign());
+    else if(this->ubig.is_zero() || big.ubig.is_zero())
+        this->clear();
+    else this->ubig *= big.ubig, this->set_sign(this->sign() != big.sign());
+    return *this;
+}
+bigint bigint::div(const bigint &big) const
+{ return std::move(this->div_mod(big).first); }
+bigint& bigint::div_eq(const bigint &big)
+{
+    // the quotient is rounded towards negative infinity, see div_mod
+    bool neg = (this->sign() != big.sign()), rem = false;
+    if(big.ubig.size() == 1)
+        rem = (this->ubig.div_eq_ull(big.ubig.digits[0]) != 0);
+    else if(this->ubig < big.ubig)
+    {
+        rem = (this->ubig != 0u);
+        this->ubig.clear();
+    }
     else
     {
-        int cmp = this->ubig.compare(big.ubig);
-        if(cmp > 0)
-            result = bigint(this->ubig - big.ubig, this->sign);
-        else if(cmp < 0)
-            result = bigint(big.ubig - this->ubig, !this->sign);
-        else result = bigint(0);
+        unsigned_bigint::limbs q;
+        this->ubig.div_mod_eq(big.ubig.view(), &q);
+        rem = (this->ubig != 0u);
+        this->ubig.digits.swap(q);
+        this->ubig.strip();
     }
-    return std::move(result);
+    if(neg && rem) this->ubig.add_eq(1u);
+    this->set_sign(neg && this->ubig != 0u);
+    return *this;
 }
-bigint& bigint::add_eq(const bigint &big)
+bigint bigint::mod(const bigint &big) const
+{ return std::move(this->div_mod(big).second); }
+bigint& bigint::mod_eq(const bigint &big)
 {
-    if(this->sign == big.sign)
-        this->ubig += big.ubig;
+    // the remainder has the same sign as the divisor, see div_mod
+    bool neg = (this->sign() != big.sign());
+    this->ubig.mod_eq(big.ubig);
+    if(this->ubig.is_zero())
+        this->set_sign(false);
     else
     {
-        int cmp = this->ubig.compare(big.ubig);
-        if(cmp > 0)
-            this->ubig -= big.ubig;
-        else if(cmp < 0)
-            *this = bigint(big.ubig - this->ubig, !this->sign);
-        else *this = bigint(0);
+        if(neg) this->ubig.rsub_eq(big.ubig.view());
+        this->set_sign(big.sign());
     }
     return *this;
 }
-bigint bigint::sub(const bigint &big) const
+
+std::pair<bigint, bigint> bigint::div_mod(const bigint &big) const
+{ return div_qr(*this, big.ubig.view(), big.sign(), rounding::floor); }
+std::pair<bigint, bigint> bigint::fdiv_qr(const bigint &d) const
+{ return div_qr(*this, d.ubig.view(), d.sign(), rounding::floor); }
+std::pair<bigint, bigint> bigint::cdiv_qr(const bigint &d) const
+{ return div_qr(*this, d.ubig.view(), d.sign(), rounding::ceil); }
+std::pair<bigint, bigint> bigint::ediv_qr(const bigint &d) const
+{ return div_qr(*this, d.ubig.view(), d.sign(), rounding::euclid); }
+bigint bigint::fmod(const bigint &d) const
+{ bigint tmp(*this); return std::move(tmp.mod_eq(d)); }
+bigint bigint::powmod(const bigint &exp, const bigint &mod) const
 {
-    bigint result;
-    if(this->sign != big.sign)
-        result = bigint(this->ubig + big.ubig, this->sign);
+    if(exp.sign())
+        throw std::runtime_error("bigint: negative exponent in powmod.");
+    unsigned_bigint r = this->ubig.powmod(exp.ubig, mod.ubig);
+    // (-x)^exp is negative if exp is odd, then reduce it to the range
+    // of div_mod, [0, mod) for positive mod and (mod, 0] for negative mod
+    bool neg = this->sign() && (exp.ubig.digits[0] & 1);
+    if(r != 0u && neg != mod.sign())
+        r.rsub_eq(mod.ubig.view());
+    bool neg_r = mod.sign() && r != 0u;
+    return bigint(std::move(r), neg_r);
+}
+void bigint::opposite() noexcept
+{ if(!this->ubig.is_zero()) this->set_sign(!this->sign()); }
+void bigint::swap(bigint  &big) noexcept
+{
+    bool s = this->sign(), t = big.sign();
+    this->ubig.swap(big.ubig);
+    this->set_sign(t);
+    big.set_sign(s);
+}
+bigint::size_type bigint::size() const noexcept
+{ return this->ubig.size(); }
+bigint::size_type bigint::capacity() const noexcept
+{ return this->ubig.capacity(); }
+void bigint::reserve(size_type limbs)
+{ this->ubig.reserve(limbs); }
+void bigint::shrink_to_fit()
+{ this->ubig.shrink_to_fit(); }
+void bigint::clear() noexcept
+{
+    this->ubig.clear();
+    this->set_sign(false);
+}
+std::string bigint::to_string(bool reverse) const
+{
+    std::string str = this->ubig.to_string(true);
+    if(this->sign()) str.push_back('-');
+    if(!reverse)
+    {
+        auto first = str.begin(), last = str.end();
+        while((first != last) && (first != --last))
+            std::iter_swap(first, last), ++first;
+    }
+    return std::move(str);
+}
+bigint::~bigint() noexcept
+{ }
+
+// private
+bigint& bigint::add_eq_small(const ull_type number, bool neg)
+{
+    if(this->sign() == neg)
+        this->ubig.add_eq_ull(number);
     else
     {
-        int cmp = this->ubig.compare(big.ubig);
+        int cmp = this->ubig.compare_ull(number);
         if(cmp > 0)
-            result = bigint(this->ubig - big.ubig, this->sign);
+            this->ubig.sub_eq_ull(number);
         else if(cmp < 0)
-            result = bigint(big.ubig - this->ubig, !this->sign);
-        else result = bigint(0);
+        {
+            this->ubig.rsub_eq_ull(number);
+            this->set_sign(neg);
+        }
+        else
+        {
+            this->ubig.clear();
+            this->set_sign(false);
+        }
     }
-    return std::move(result);
+    return *this;
 }
-bigint& bigint::sub_eq(const bigint &big)
+bigint& bigint::multi_eq_small(const ull_type number, bool neg)
 {
-    if(this->sign != big.sign)
-        this->ubig += big.ubig;
+    if(number == 0 || this->ubig.is_zero())
+    {
+        this->ubig.clear();
+        this->set_sign(false);
+    }
     else
     {
-        int cmp = this->ubig.compare(big.ubig);
-        if(cmp > 0)
-            this->ubig -= big.ubig;
-        else if(cmp < 0)
-            *this = bigint(big.ubig - this->ubig, !this->sign);
-        else *this = bigint(0);
+        this->ubig.multi_eq_ull(number);
+        this->set_sign(this->sign() != neg);
     }
     return *this;
 }
-bigint bigint::multi(const bigint &big) const
+bigint& bigint::div_eq_small(const ull_type number, bool neg)
 {
-    if(this->ubig == 0 || big.ubig == 0) return bigint(0);
-    return bigint(this->ubig * big.ubig, this->sign ^ big.sign);
+    // same rule as div_mod, the quotient is rounded towards negative infinity
+    bool neg_q = (this->sign() != neg);
+    ull_type rem = this->ubig.div_eq_ull(number);
+    if(neg_q && rem != 0)
+        this->ubig.add_eq(1u);
+    this->set_sign(neg_q);
+    return *this;
 }
-bigint& bigint::multi_eq(const bigint &big)
+bigint& bigint::mod_eq_small(const ull_type number, bool neg)
 {
-    if(this->ubig == 0 || big.ubig == 0) *this = bigint(0);
-    else this->ubig *= big.ubig, this->sign ^= big.sign;
+    // the remainder has the same sign as the divisor
+    ull_type rem = this->ubig.div_eq_ull(number);
+    if(rem != 0 && this->sign() != neg)
+        rem = number - rem;
+    this->ubig.assign_ull(rem);
+    this->set_sign(rem != 0 && neg);
     return *this;
 }
-bigint bigint::div(const bigint &big) const
-{ return std::move(this->div_mod(big).first); }
-bigint& bigint::div_eq(const bigint &big)
-{ return *this = this->div_mod(big).first; }
-bigint bigint::mod(const bigint &big) const
-{ return std::move(this->div_mod(big).second); }
-bigint& bigint::mod_eq(const bigint &big)
-{ return *this = this->div_mod(big).second; }
-
-std::pair<bigint, bigint> bigint::div_mod(const bigint &big) const
+std::pair<bigint, bigint>
+bigint::div_qr(const bigint &n, mpn::const_view d, bool d_sign, rounding mode)
 {
-    auto result = this->ubig.div_mod(big.ubig);
-    if(this->sign == big.sign)
-        return std::make_pair(bigint(std::move(result.first)),
-                              bigint(std::move(result.second)));
+    // the truncated quotient and remainder of the magnitudes
+    bigint q, r;
+    if(n.is_word() && unsigned_bigint::is_word(d) && !d.is_zero())
+    {
+        ull_type x = n.word(), y = unsigned_bigint::word(d);
+        q.ubig.assign_ull(x / y);
+        r.ubig.assign_ull(x % y);
+    }
+    else if(d.size() == 1)
+    {
+        q.ubig = n.ubig;
+        r.ubig.assign_ull(q.ubig.div_eq_ull(d[0]));
+    }
+    else if(n.ubig.compare(d) < 0)
+        r.ubig = n.ubig;
     else
     {
-        // if they have different sign, adjust the result as follow.
-        // for example, -11/7 = -2 ... 3, and 11 / -7 = -2 ... -3
-        // but 11 / 7 = 1 ... 4
-        if(result.second != 0u)
+        unsigned_bigint::limbs ql;
+        r.ubig = n.ubig;
+        r.ubig.div_mod_eq(d, &ql);
+        q.ubig.digits.swap(ql);
+        q.ubig.strip();
+    }
+
+    // a nonzero remainder moves the quotient one away from zero if it has
+    // the wrong sign for the rounding, -7 = -3 * 2 - 1 = -4 * 2 + 1
+    bool n_sign = n.sign(), adjust = false;
+    if(!r.ubig.is_zero())
+    {
+        switch(mode)
         {
-            ++result.first;
-            result.second = big.ubig - result.second;
-            return std::make_pair(bigint(std::move(result.first), 1),
-                        bigint(std::move(result.second), big.sign));
+        case rounding::floor:  adjust = (n_sign != d_sign); break;
+        case rounding::ceil:   adjust = (n_sign == d_sign); break;
+        case rounding::euclid: adjust = n_sign; break;
         }
-        else
-            return std::make_pair(bigint(std::move(result.first), 1),
-                        bigint(0));
     }
+    bool r_sign = n_sign;
+    if(adjust)
+    {
+        q.ubig.add_eq(1u);
+        r.ubig.rsub_eq(d);
+        r_sign = (mode == rounding::floor ? d_sign :
+                  mode == rounding::ceil ? !d_sign : false);
+    }
+    q.set_sign(n_sign != d_sign && !q.ubig.is_zero());
+    r.set_sign(r_sign && !r.ubig.is_zero());
+    return std::make_pair(std::move(q), std::move(r));
 }
-void bigint::opposite() noexcept
-{ if(*this != bigint(0)) this->sign = !this->sign; }
-void bigint::swap(bigint  &big) noexcept
+std::pair<bigint, bigint>
+bigint::div_qr_small(const ull_type d, bool neg, rounding mode) const
 {
-    std::swap(this->sign, big.sign);
-    this->ubig.swap(big.ubig);
+    const unsigned_bigint::uint_type b[2] = {
+        unsigned_bigint::uint_type(d), unsigned_bigint::uint_type(d >> 32)};
+    return div_qr(*this, mpn::const_view(b, b[1] ? 2 : 1), neg, mode);
 }
-bigint::size_type bigint::size() const noexcept
-{ return this->ubig.size(); }
-std::string bigint::to_string(bool reverse) const
+bigint bigint::add_signed(const bigint &a, const bigint &b, bool b_sign)
 {
-    std::string str = this->ubig.to_string(true);
-    if(this->sign) str.push_back('-');
-    if(!reverse)
+    using limbs = unsigned_bigint::limbs;
+    if(a.is_word() && b.is_word())
     {
-        auto first = str.begin(), last = str.end();
-        while((first != last) && (first != --last))
-            std::iter_swap(first, last), ++first;
+        // both in a machine word, the common case
+        ull_type x = a.word(), y = b.word(), r;
+        bigint result;
+        if(a.sign() != b_sign)
+            result.set_word(x >= y ? x - y : y - x, x >= y ? a.sign() : b_sign);
+        else if(!_k_help::add_overflow(x, y, r))
+            result.set_word(r, a.sign());
+        else
+        {
+            const uint_type limbs[3] = {uint_type(r), uint_type(r >> 32), 1};
+            result = bigint(unsigned_bigint(unsigned_bigint::const_view(limbs, 3)), a.sign());
+        }
+        return result;
     }
-    return std::move(str);
+    unsigned_bigint::const_view av = a.ubig.view(), bv = b.ubig.view();
+    if(a.sign() == b_sign)
+    {
+        if(av.size() < bv.size()) std::swap(av, bv);
+        limbs r(av.size() + 1);
+        r[av.size()] = mpn::add(r.data(), av.data(), av.size(), bv.data(), bv.size());
+        return bigint(unsigned_bigint(std::move(r), true), a.sign());
+    }
+    // |a| - |b| or |b| - |a|, the only comparison of the magnitudes
+    int cmp = a.ubig.compare(bv);
+    if(cmp == 0) return bigint();
+    bool neg = cmp > 0 ? a.sign() : b_sign;
+    if(cmp < 0) std::swap(av, bv);
+    limbs r(av.size());
+    mpn::sub(r.data(), av.data(), av.size(), bv.data(), bv.size());
+    return bigint(unsigned_bigint(std::move(r), true), neg);
+}
+bigint& bigint::add_eq_signed(const bigint &big, bool big_sign)
+{
+    if(this->is_word() && big.is_word())
+    {
+        ull_type x = this->word(), y = big.word(), r;
+        if(this->sign() != big_sign)
+        {
+            this->set_word(x >= y ? x - y : y - x, x >= y ? this->sign() : big_sign);
+            return *this;
+        }
+        if(!_k_help::add_overflow(x, y, r))
+        {
+            this->set_word(r, big_sign);
+            return *this;
+        }
+    }
+    if(this->sign() == big_sign)
+    {
+        this->ubig.add_eq(big.ubig);
+        return *this;
+    }
+    // big is not *this here, unless both are zero
+    unsigned_bigint::const_view b = big.ubig.view();
+    int cmp = this->ubig.compare(b);
+    if(cmp == 0)
+    {
+        this->clear();
+        return *this;
+    }
+    unsigned_bigint::limbs &a = this->ubig.digits;
+    size_type an = a.size();
+    if(cmp > 0)
+        mpn::sub(a.data(), a.data(), an, b.data(), b.size());
+    else
+    {
+        a.resize(b.size());
+        mpn::sub(a.data(), b.data(), b.size(), a.data(), an);
+        this->set_sign(big_sign);
+    }
+    this->ubig.strip();
+    return *this;
+}
+void bigint::set_word(const ull_type magnitude, bool neg)
+{
+    this->ubig.assign_ull(magnitude);
+    this->set_sign(neg && magnitude != 0);
+}
+int bigint::compare_small(const ull_type number, bool neg) const noexcept
+{
+    // a zero number is never negative
+    if(this->sign() != (neg && number != 0))
+        return this->sign() ? -1 : 1;
+    int cmp = this->ubig.compare_ull(number);
+    return this->sign() ? -cmp : cmp;
+}
+bigint bigint::bitwise(const bigint &a, const bigint &b, char op)
+{
+    unsigned_bigint::const_view av = a.ubig.view(), bv = b.ubig.view();
+    // a zero magnitude is taken as +0 whatever its sign
+    twos_complement ta(av.data(), av.size(), a.sign() && !av.is_zero());
+    twos_complement tb(bv.data(), bv.size(), b.sign() && !bv.is_zero());
+    unsigned_bigint::limbs r(std::max(av.size(), bv.size()) + 1);
+    uint32_t *rp = r.data();
+    bool neg;
+    if(op == '&')
+        neg = bitwise_limbs(rp, r.size(), ta, tb, [](uint32_t x, uint32_t y) { return x & y; });
+    else if(op == '|')
+        neg = bitwise_limbs(rp, r.size(), ta, tb, [](uint32_t x, uint32_t y) { return x | y; });
+    else
+        neg = bitwise_limbs(rp, r.size(), ta, tb, [](uint32_t x, uint32_t y) { return x ^ y; });
+    return bigint(unsigned_bigint(std::move(r), true), neg);
 }
-bigint::~bigint() noexcept
-{ }
 
 // non-member function
 void swap(bigint &big1, bigint &big2) noexcept
@@ -0,0 +1,152 @@
+#include "kedixa/limb_vector.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace kedixa {
+
+namespace _k_help {
+
+// constructors
+limb_vector::limb_vector(size_type count, value_type value)
+    : limb_vector()
+{ this->assign(count, value); }
+limb_vector::limb_vector(const std::vector<value_type> &v)
+    : limb_vector()
+{ this->assign(v.begin(), v.end()); }
+limb_vector::limb_vector(const limb_vector &lv)
+    : limb_vector()
+{ *this = lv; }
+
+// assignment operators
+limb_vector& limb_vector::operator=(const limb_vector &lv)
+{
+    if(this == &lv)
+        return *this;
+    if(!this->is_inline() && !lv.is_inline() && this->u.p == lv.u.p
+       && this->len() == lv.len())
+        return *this;
+    // share the buffer only if it is large and tight, a buffer with much
+    // unused capacity is usually an accumulator that will be written soon
+    if(!lv.is_inline() && lv.len() >= SHARE_HINT && lv.capacity() < 2 * lv.len())
+    {
+        lv.head()->refs.fetch_add(1, std::memory_order_relaxed);
+        if(!this->is_inline()) release(this->u.p);
+        this->u.p = lv.u.p;
+        this->n = (this->n & TAG) | lv.len();
+    }
+    else
+        this->assign(lv.begin(), lv.end());
+    return *this;
+}
+
+// capacity
+void limb_vector::reserve(size_type count)
+{
+    if(count > this->capacity())
+        this->reallocate(count);
+}
+void limb_vector::shrink_to_fit()
+{
+    if(this->is_inline() || this->shared() || this->capacity() == this->len())
+        return;
+    this->reallocate(this->len());
+}
+
+// modifiers
+void limb_vector::assign(size_type count, value_type value)
+{
+    this->prepare(count, false);
+    std::fill(this->buf(), this->buf() + count, value);
+    this->set_len(count);
+}
+void limb_vector::push_back(value_type value)
+{
+    size_type len = this->len();
+    this->prepare(len + 1, true);
+    this->buf()[len] = value;
+    this->set_len(len + 1);
+}
+limb_vector::iterator
+limb_vector::insert(const_iterator pos, size_type count, value_type value)
+{
+    size_type idx = pos - this->cbegin(), len = this->len();
+    this->prepare(len + count, true);
+    value_type *first = this->buf() + idx;
+    std::memmove(first + count, first, (len - idx) * sizeof(value_type));
+    std::fill(first, first + count, value);
+    this->set_len(len + count);
+    return first;
+}
+limb_vector::iterator
+limb_vector::erase(const_iterator first, const_iterator last)
+{
+    size_type idx = first - this->cbegin(), count = last - first, len = this->len();
+    this->unshare();
+    value_type *pos = this->buf() + idx;
+    std::memmove(pos, pos + count, (len - idx - count) * sizeof(value_type));
+    this->set_len(len - count);
+    return pos;
+}
+void limb_vector::clear() noexcept
+{ this->set_len(0); }
+
+// private
+limb_vector::value_type* limb_vector::allocate(size_type cap)
+{
+    void *mem = ::operator new(sizeof(header) + cap * sizeof(value_type));
+    header *h = new(mem) header;
+    h->refs.store(1, std::memory_order_relaxed);
+    h->cap = cap;
+    return reinterpret_cast<value_type*>(h + 1);
+}
+void limb_vector::release(value_type *p) noexcept
+{
+    if(p == nullptr) return;
+    header *h = reinterpret_cast<header*>(p) - 1;
+    if(h->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        h->~header();
+        ::operator delete(static_cast<void*>(h));
+    }
+}
+void limb_vector::reallocate(size_type cap)
+{
+    size_type count = std::min(this->len(), cap);
+    storage s;
+    value_type *q = cap <= INLINE_CAP ? s.small : (s.p = allocate(cap));
+    if(count) std::memcpy(q, this->buf(), count * sizeof(value_type));
+    if(!this->is_inline()) release(this->u.p);
+    this->u = s;
+    this->n = (this->n & TAG) | (cap <= INLINE_CAP ? INLINE : 0) | count;
+}
+void limb_vector::prepare(size_type count, bool keep)
+{
+    size_type cap = this->capacity();
+    size_type new_cap;
+    if(this->shared())
+        new_cap = keep ? std::max(count, this->len()) : count;
+    else if(count > cap)
+        new_cap = std::max(count, cap + cap / 2);
+    else return;
+
+    if(keep) this->reallocate(new_cap);
+    else
+    {
+        // drop the old limbs first, the object is a valid empty vector
+        // if the allocation throws
+        if(!this->is_inline()) release(this->u.p);
+        this->u.p = nullptr;
+        this->n = (this->n & TAG) | INLINE;
+        if(new_cap > INLINE_CAP)
+        {
+            this->u.p = allocate(new_cap);
+            this->n &= ~INLINE;
+        }
+    }
+}
+
+} // namespace _k_help
+
+} // namespace kedixa
@@ -0,0 +1,92 @@
+#include "kedixa/modint.h"
+
+#include <stdexcept>
+
+namespace kedixa {
+
+// constructors
+modint::modint(const context_ptr &ctx, const ubigint &value)
+    : ctx(ctx), mont(ctx->to_mont(value))
+{ }
+modint::modint(const context_ptr &ctx, const uint_type value)
+    : modint(ctx, ubigint(value))
+{ }
+modint::modint(const context_ptr &ctx, ubigint &&mont, bool)
+    : ctx(ctx), mont(std::move(mont))
+{ }
+
+modint::context_ptr modint::make_context(const ubigint &modulus)
+{ return std::make_shared<const montgomery_context>(modulus); }
+
+// assignment operators
+modint& modint::operator+=(const modint &mi)
+{
+    this->check_context(mi);
+    this->mont += mi.mont;
+    if(this->mont >= this->modulus())
+        this->mont -= this->modulus();
+    return *this;
+}
+modint& modint::operator-=(const modint &mi)
+{
+    this->check_context(mi);
+    if(this->mont < mi.mont)
+        this->mont += this->modulus();
+    this->mont -= mi.mont;
+    return *this;
+}
+modint& modint::operator*=(const modint &mi)
+{
+    this->check_context(mi);
+    if(this == &mi) this->ctx->sqr_eq(this->mont);
+    else this->ctx->mul_eq(this->mont, mi.mont);
+    return *this;
+}
+modint& modint::operator/=(const modint &mi)
+{
+    this->check_context(mi);
+    return *this *= mi.inverse();
+}
+
+modint modint::operator- () const
+{
+    if(this->is_zero()) return *this;
+    return modint(this->ctx, this->modulus() - this->mont, true);
+}
+
+// others
+unsigned_bigint modint::value() const
+{ return this->ctx->from_mont(this->mont); }
+modint modint::pow(const ubigint &exp) const
+{
+    // square and multiply from the highest bit, in the Montgomery form of
+    // the shared context
+    size_type bits = exp.bit_length();
+    if(bits == 0) return modint(this->ctx, 1u);
+    ubigint r = this->mont;
+    for(size_type i = bits - 1; i-- > 0; )
+    {
+        this->ctx->sqr_eq(r);
+        if(exp.test_bit(i)) this->ctx->mul_eq(r, this->mont);
+    }
+    return modint(this->ctx, std::move(r), true);
+}
+modint modint::inverse() const
+{ return modint(this->ctx, this->value().invert(this->modulus())); }
+void modint::swap(modint &mi) noexcept
+{
+    this->ctx.swap(mi.ctx);
+    this->mont.swap(mi.mont);
+}
+
+// private
+void modint::check_context(const modint &mi) const
+{
+    if(this->ctx != mi.ctx && this->modulus() != mi.modulus())
+        throw std::runtime_error("modint: different moduli.");
+}
+
+void swap(modint &a, modint &b) noexcept
+{ a.swap(b); }
+
+} // namespace kedixa
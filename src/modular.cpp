@@ -0,0 +1,434 @@
+#include "kedixa/modular.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace kedixa {
+
+namespace {
+
+using uint_type = unsigned_bigint::uint_type;
+
+// the products of at least this many limbs are reduced by Barrett's
+// method, the shorter ones by the schoolbook division
+const unsigned_bigint::size_type MULTI_MOD_BARRETT_THRESHOLD = 16;
+
+// inv = a^(-1) mod m, false if gcd(a, m) != 1
+bool inverse_mod(uint_type a, uint_type m, uint_type &inv) noexcept
+{
+    int64_t r0 = m, r1 = a % m, s0 = 0, s1 = 1;
+    while(r1 != 0)
+    {
+        int64_t q = r0 / r1, t;
+        t = r0 - q * r1, r0 = r1, r1 = t;
+        t = s0 - q * s1, s0 = s1, s1 = t;
+    }
+    inv = uint_type(s0 < 0 ? s0 + m : s0);
+    return r0 == 1;
+}
+
+unsigned_bigint from_dlimb(mpn::dlimb_type x)
+{
+    mpn::limb_type l[2] = {mpn::limb_type(x), mpn::limb_type(x >> mpn::LIMB_BITS)};
+    return unsigned_bigint(mpn::const_view(l, 2));
+}
+
+} // namespace
+
+// montgomery_context
+montgomery_context::montgomery_context(const ubigint &modulus)
+    : mod(modulus)
+{
+    ubigint::const_view v = mod.view();
+    if(v[0] % 2 == 0)
+        throw std::runtime_error("montgomery_context: modulus must be odd.");
+    n = v.size();
+    w = mpn::mont_size(n);
+    minv = mpn::mont_inverse(v[0]);
+    m.assign(w, 0);
+    std::copy(v.begin(), v.end(), m.begin());
+    one.assign(w, 0);
+    one[0] = 1;
+
+    // R^2 mod N, the only division of the context
+    std::vector<uint_type> x(2 * w + 1, 0);
+    x[2 * w] = 1;
+    r2.assign(w, 0);
+    mpn::divrem(nullptr, r2.data(), x.data(), x.size(), m.data(), n);
+    ws.assign(4 * w + mpn::mont_mul_itch(w), 0);
+}
+
+unsigned_bigint montgomery_context::to_mont(const ubigint &x) const
+{
+    uint_type *a = ws.data();
+    ubigint::const_view v = x.view();
+    if(v.size() < n || (v.size() == n && mpn::cmp(v.data(), m.data(), n) < 0))
+        this->load(a, x);
+    else
+    {
+        mpn::divrem(nullptr, a, v.data(), v.size(), m.data(), n);
+        std::fill(a + n, a + w, uint_type(0));
+    }
+    this->to_mont(a, a);
+    ubigint r;
+    this->store(r, a);
+    return r;
+}
+unsigned_bigint montgomery_context::from_mont(const ubigint &x) const
+{
+    uint_type *a = ws.data();
+    this->load(a, x);
+    this->from_mont(a, a);
+    ubigint r;
+    this->store(r, a);
+    return r;
+}
+unsigned_bigint montgomery_context::mul(const ubigint &a, const ubigint &b) const
+{
+    ubigint r(a);
+    this->mul_eq(r, b);
+    return r;
+}
+unsigned_bigint montgomery_context::sqr(const ubigint &a) const
+{
+    ubigint r(a);
+    this->sqr_eq(r);
+    return r;
+}
+void montgomery_context::mul_eq(ubigint &a, const ubigint &b) const
+{
+    uint_type *ap = ws.data(), *bp = ap + w;
+    this->load(ap, a);
+    this->load(bp, b);
+    this->mul(ap, ap, bp);
+    this->store(a, ap);
+}
+void montgomery_context::sqr_eq(ubigint &a) const
+{
+    uint_type *ap = ws.data();
+    this->load(ap, a);
+    this->sqr(ap, ap);
+    this->store(a, ap);
+}
+unsigned_bigint montgomery_context::reduce(const ubigint &x) const
+{
+    uint_type *ap = ws.data(), *tp = ap + w;
+    ubigint::const_view v = x.view();
+    std::copy(v.begin(), v.end(), tp);
+    std::fill(tp + v.size(), tp + 2 * w, uint_type(0));
+    this->reduce(ap, tp);
+    ubigint r;
+    this->store(r, ap);
+    return r;
+}
+
+void montgomery_context::to_mont(uint_type *rp, const uint_type *ap) const noexcept
+{ this->mul(rp, ap, r2.data()); }
+void montgomery_context::from_mont(uint_type *rp, const uint_type *ap) const noexcept
+{ this->mul(rp, ap, one.data()); }
+void montgomery_context::mul(uint_type *rp, const uint_type *ap, const uint_type *bp) const noexcept
+{ mpn::mont_mul(rp, ap, bp, m.data(), w, minv, ws.data() + 4 * w); }
+void montgomery_context::sqr(uint_type *rp, const uint_type *ap) const noexcept
+{ mpn::mont_mul(rp, ap, ap, m.data(), w, minv, ws.data() + 4 * w); }
+void montgomery_context::reduce(uint_type *rp, uint_type *tp) const noexcept
+{ mpn::redc(rp, tp, m.data(), w, minv); }
+
+// private
+void montgomery_context::load(uint_type *p, const ubigint &x) const noexcept
+{
+    ubigint::const_view v = x.view();
+    std::copy(v.begin(), v.end(), p);
+    std::fill(p + v.size(), p + w, uint_type(0));
+}
+void montgomery_context::store(ubigint &x, const uint_type *p) const
+{
+    // the capacity of x is reused, the padding limbs are all zero
+    x.digits.resize(n);
+    std::copy(p, p + n, x.digits.data());
+    x.strip();
+}
+
+// barrett_context
+barrett_context::barrett_context(const ubigint &modulus)
+    : mod(modulus)
+{
+    if(mod == 0)
+        throw std::runtime_error("barrett_context: modulus must not be zero.");
+    ubigint::const_view v = mod.view();
+    n = v.size();
+    m.assign(n + 1, 0);
+    std::copy(v.begin(), v.end(), m.begin());
+
+    // mu = floor(B^2n / N) has n + 2 limbs only if N = B^(n-1), then
+    // B^(n+1) - 1 is used, which costs at most one more subtraction
+    std::vector<uint_type> x(2 * n + 1, 0), q(n + 2);
+    x[2 * n] = 1;
+    mpn::divrem(q.data(), x.data(), x.data(), x.size(), m.data(), n);
+    if(q[n+1]) mu.assign(n + 1, ~uint_type(0));
+    else mu.assign(q.begin(), q.begin() + n + 1);
+    ws.assign(4 * n + 2 * (2 * n + 2) + n + 1 + mpn::mul_n_itch(n + 1), 0);
+}
+
+unsigned_bigint barrett_context::reduce(const ubigint &x) const
+{
+    uint_type *ap = ws.data(), *tp = ap + 2 * n;
+    ubigint::const_view v = x.view();
+    size_type xn = v.size();
+    size_type start = xn > 2 * n ? xn - 2 * n : 0;
+    std::copy(v.begin() + start, v.end(), tp);
+    std::fill(tp + (xn - start), tp + 2 * n, uint_type(0));
+    this->reduce(ap, tp);
+    // fold the lower limbs in, at most n limbs each time, so that
+    // a * B^step + chunk < N * B^n stays within 2n limbs
+    while(start > 0)
+    {
+        size_type step = std::min(n, start);
+        start -= step;
+        std::copy(v.begin() + start, v.begin() + start + step, tp);
+        std::copy(ap, ap + n, tp + step);
+        std::fill(tp + step + n, tp + 2 * n, uint_type(0));
+        this->reduce(ap, tp);
+    }
+    ubigint r;
+    this->store(r, ap);
+    return r;
+}
+unsigned_bigint barrett_context::mul(const ubigint &a, const ubigint &b) const
+{
+    ubigint r(a);
+    this->mul_eq(r, b);
+    return r;
+}
+unsigned_bigint barrett_context::sqr(const ubigint &a) const
+{
+    ubigint r(a);
+    this->sqr_eq(r);
+    return r;
+}
+void barrett_context::mul_eq(ubigint &a, const ubigint &b) const
+{
+    uint_type *ap = ws.data(), *bp = ap + n;
+    this->load(ap, a);
+    this->load(bp, b);
+    this->mul(ap, ap, bp);
+    this->store(a, ap);
+}
+void barrett_context::sqr_eq(ubigint &a) const
+{
+    uint_type *ap = ws.data();
+    this->load(ap, a);
+    this->sqr(ap, ap);
+    this->store(a, ap);
+}
+
+void barrett_context::reduce(uint_type *rp, const uint_type *xp) const noexcept
+{
+    // implement Algorithm 14.42 in Handbook of Applied Cryptography,
+    // q = floor(floor(x / B^(n-1)) * mu / B^(n+1)) is at most 3 less than
+    // floor(x / N), so r = x - q * N is computed mod B^(n+1)
+    uint_type *qp = ws.data() + 4 * n, *sp = qp + 2 * n + 2;
+    uint_type *r = sp + 2 * n + 2, *mws = r + n + 1;
+    mpn::mul_n(qp, xp + n - 1, mu.data(), n + 1, mws);
+    mpn::mul_n(sp, qp + n + 1, m.data(), n + 1, mws);
+    mpn::sub_n(r, xp, sp, n + 1);
+    while(mpn::cmp(r, m.data(), n + 1) >= 0)
+        mpn::sub_n(r, r, m.data(), n + 1);
+    std::copy(r, r + n, rp);
+}
+void barrett_context::mul(uint_type *rp, const uint_type *ap, const uint_type *bp) const noexcept
+{
+    uint_type *tp = ws.data() + 2 * n, *mws = tp + 2 * n + 2 * (2 * n + 2) + n + 1;
+    mpn::mul_n(tp, ap, bp, n, mws);
+    this->reduce(rp, tp);
+}
+void barrett_context::sqr(uint_type *rp, const uint_type *ap) const noexcept
+{
+    uint_type *tp = ws.data() + 2 * n, *mws = tp + 2 * n + 2 * (2 * n + 2) + n + 1;
+    mpn::sqr_n(tp, ap, n, mws);
+    this->reduce(rp, tp);
+}
+
+// private
+void barrett_context::load(uint_type *p, const ubigint &x) const noexcept
+{
+    ubigint::const_view v = x.view();
+    std::copy(v.begin(), v.end(), p);
+    std::fill(p + v.size(), p + n, uint_type(0));
+}
+void barrett_context::store(ubigint &x, const uint_type *p) const
+{
+    x.digits.resize(n);
+    std::copy(p, p + n, x.digits.data());
+    x.strip();
+}
+
+// multi_mod_context
+multi_mod_context::multi_mod_context(const std::vector<uint_type> &moduli)
+    : mods(moduli), crt_ready(false), is_coprime(false)
+{
+    // the groups, there is one group of product 1 if there are no moduli
+    std::vector<node> leaves;
+    mpn::dlimb_type prod = 1;
+    first.push_back(0);
+    for(size_type i = 0; i < mods.size(); ++i)
+    {
+        if(mods[i] == 0)
+            throw std::runtime_error("multi_mod_context: moduli must not be zero.");
+        if(prod * mods[i] >> mpn::LIMB_BITS)
+        {
+            leaves.push_back(node{ubigint(uint_type(prod)), npos});
+            first.push_back(i);
+            prod = 1;
+        }
+        prod *= mods[i];
+    }
+    leaves.push_back(node{ubigint(uint_type(prod)), npos});
+    first.push_back(mods.size());
+    tree.push_back(std::move(leaves));
+
+    // a node without sibling is moved up as it is
+    while(tree.back().size() > 1)
+    {
+        const std::vector<node> &lower = tree.back();
+        std::vector<node> upper;
+        for(size_type i = 0; i + 1 < lower.size(); i += 2)
+        {
+            node nd{lower[i].prod * lower[i+1].prod, npos};
+            if(nd.prod.view().size() >= MULTI_MOD_BARRETT_THRESHOLD)
+            {
+                nd.ctx = ctxs.size();
+                ctxs.emplace_back(nd.prod);
+            }
+            upper.push_back(std::move(nd));
+        }
+        if(lower.size() % 2)
+            upper.push_back(lower.back());
+        tree.push_back(std::move(upper));
+    }
+}
+
+bool multi_mod_context::coprime() const
+{
+    this->prepare_crt();
+    return is_coprime;
+}
+
+std::vector<unsigned_bigint::uint_type> multi_mod_context::residues(const ubigint &x) const
+{
+    std::vector<uint_type> rs;
+    this->residues(x, rs);
+    return rs;
+}
+void multi_mod_context::residues(const ubigint &x, std::vector<uint_type> &rs) const
+{
+    // the remainders modulo the nodes of each level, from the root down
+    std::vector<ubigint> vals(1, this->reduce(tree.back()[0], x)), lower;
+    for(size_type l = tree.size() - 1; l-- > 0; )
+    {
+        const std::vector<node> &level = tree[l];
+        lower.resize(level.size());
+        for(size_type i = 0; i < level.size(); ++i)
+            lower[i] = this->reduce(level[i], vals[i / 2]);
+        vals.swap(lower);
+    }
+    rs.resize(mods.size());
+    for(size_type g = 0; g + 1 < first.size(); ++g)
+    {
+        uint_type v = uint_type(vals[g]);
+        for(size_type i = first[g]; i < first[g+1]; ++i)
+            rs[i] = v % mods[i];
+    }
+}
+
+unsigned_bigint multi_mod_context::crt(const std::vector<uint_type> &rs) const
+{
+    if(rs.size() != mods.size())
+        throw std::runtime_error("multi_mod_context: one residue is needed for each modulus.");
+    this->prepare_crt();
+    if(!is_coprime)
+        throw std::runtime_error("multi_mod_context: moduli are not pairwise coprime.");
+
+    // x = sum c_i * M / m_i with c_i = rs[i] * inv[i] mod m_i, the sums of
+    // the subtrees are combined up to the root, and are reduced at last
+    std::vector<ubigint> vals(tree[0].size()), upper;
+    for(size_type g = 0; g < vals.size(); ++g)
+    {
+        uint_type gp = uint_type(tree[0][g].prod);
+        mpn::dlimb_type sum = 0;
+        for(size_type i = first[g]; i < first[g+1]; ++i)
+        {
+            uint_type m = mods[i];
+            mpn::dlimb_type c = mpn::dlimb_type(rs[i] % m) * inv[i] % m;
+            sum += c * (gp / m);
+        }
+        vals[g] = from_dlimb(sum);
+    }
+    for(size_type l = 1; l < tree.size(); ++l)
+    {
+        const std::vector<node> &lower = tree[l-1];
+        upper.resize(tree[l].size());
+        for(size_type i = 0; i < upper.size(); ++i)
+        {
+            if(2 * i + 1 < lower.size())
+                upper[i] = vals[2*i] * lower[2*i+1].prod + vals[2*i+1] * lower[2*i].prod;
+            else
+                upper[i] = std::move(vals[2*i]);
+        }
+        vals.swap(upper);
+    }
+    return this->reduce(tree.back()[0], vals[0]);
+}
+
+// private
+unsigned_bigint multi_mod_context::reduce(const node &nd, const ubigint &x) const
+{
+    if(x < nd.prod) return x;
+    if(nd.ctx != npos) return ctxs[nd.ctx].reduce(x);
+    return x % nd.prod;
+}
+void multi_mod_context::prepare_crt() const
+{
+    if(crt_ready) return;
+    // the cofactors M / P mod P for the product P of each node, from the
+    // root down, then M / m_i mod m_i from the one of its group
+    std::vector<ubigint> cof(1, ubigint(1u)), lower;
+    for(size_type l = tree.size() - 1; l-- > 0; )
+    {
+        const std::vector<node> &level = tree[l];
+        lower.resize(level.size());
+        for(size_type i = 0; i < level.size(); i += 2)
+        {
+            if(i + 1 == level.size())
+                lower[i] = cof[i / 2];
+            else
+            {
+                lower[i] = this->reduce(level[i], cof[i / 2] * level[i+1].prod);
+                lower[i+1] = this->reduce(level[i+1], cof[i / 2] * level[i].prod);
+            }
+        }
+        cof.swap(lower);
+    }
+    inv.resize(mods.size());
+    is_coprime = true;
+    for(size_type g = 0; g + 1 < first.size(); ++g)
+    {
+        uint_type gp = uint_type(tree[0][g].prod), c = uint_type(cof[g]);
+        for(size_type i = first[g]; i < first[g+1]; ++i)
+        {
+            uint_type m = mods[i];
+            uint_type a = uint_type(mpn::dlimb_type(c % m) * ((gp / m) % m) % m);
+            if(!inverse_mod(a, m, inv[i]))
+                is_coprime = false;
+        }
+    }
+    crt_ready = true;
+}
+
+std::vector<unsigned_bigint::uint_type>
+multi_mod(const unsigned_bigint &x, const std::vector<unsigned_bigint::uint_type> &moduli)
+{ return multi_mod_context(moduli).residues(x); }
+unsigned_bigint crt(const std::vector<unsigned_bigint::uint_type> &rs,
+                    const std::vector<unsigned_bigint::uint_type> &moduli)
+{ return multi_mod_context(moduli).crt(rs); }
+
+} // namespace kedixa
@@ -0,0 +1,663 @@
+#include "kedixa/mpn.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+namespace kedixa {
+
+namespace mpn {
+
+const limb_type const_view::ZERO = 0;
+
+int cmp(const limb_type *ap, const limb_type *bp, size_type n) noexcept
+{
+    for(size_type i = n - 1; i != (size_type)-1; --i)
+        if(ap[i] != bp[i]) return (ap[i] < bp[i]) ? -1 : 1;
+    return 0;
+}
+size_type normalize(const limb_type *ap, size_type n) noexcept
+{
+    while(n > 0 && ap[n-1] == 0) --n;
+    return n;
+}
+
+limb_type add_n(limb_type *rp, const limb_type *ap, const limb_type *bp, size_type n) noexcept
+{
+    dlimb_type carry = 0;
+    for(size_type i = 0; i < n; ++i)
+    {
+        carry += dlimb_type(ap[i]) + bp[i];
+        rp[i] = limb_type(carry);
+        carry >>= LIMB_BITS;
+    }
+    return limb_type(carry);
+}
+limb_type add_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept
+{
+    size_type i = 0;
+    for(; b && i < n; ++i)
+    {
+        limb_type x = ap[i] + b;
+        b = (x < b);
+        rp[i] = x;
+    }
+    if(rp != ap && i < n)
+        std::memcpy(rp + i, ap + i, (n - i) * sizeof(limb_type));
+    return b;
+}
+limb_type add(limb_type *rp, const limb_type *ap, size_type an,
+              const limb_type *bp, size_type bn) noexcept
+{
+    limb_type carry = add_n(rp, ap, bp, bn);
+    return add_1(rp + bn, ap + bn, an - bn, carry);
+}
+limb_type sub_n(limb_type *rp, const limb_type *ap, const limb_type *bp, size_type n) noexcept
+{
+    limb_type borrow = 0;
+    for(size_type i = 0; i < n; ++i)
+    {
+        limb_type a = ap[i], b = bp[i];
+        limb_type x = a - b - borrow;
+        borrow = (a < b) || (a == b && borrow);
+        rp[i] = x;
+    }
+    return borrow;
+}
+limb_type sub_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept
+{
+    size_type i = 0;
+    for(; b && i < n; ++i)
+    {
+        limb_type a = ap[i];
+        rp[i] = a - b;
+        b = (a < b);
+    }
+    if(rp != ap && i < n)
+        std::memcpy(rp + i, ap + i, (n - i) * sizeof(limb_type));
+    return b;
+}
+limb_type sub(limb_type *rp, const limb_type *ap, size_type an,
+              const limb_type *bp, size_type bn) noexcept
+{
+    limb_type borrow = sub_n(rp, ap, bp, bn);
+    return sub_1(rp + bn, ap + bn, an - bn, borrow);
+}
+
+limb_type mul_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept
+{
+    dlimb_type carry = 0;
+    for(size_type i = 0; i < n; ++i)
+    {
+        carry += dlimb_type(ap[i]) * b;
+        rp[i] = limb_type(carry);
+        carry >>= LIMB_BITS;
+    }
+    return limb_type(carry);
+}
+limb_type addmul_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept
+{
+    // (B-1) * (B-1) + 2 * (B-1) == B^2 - 1, so carry never overflows
+    dlimb_type carry = 0;
+    for(size_type i = 0; i < n; ++i)
+    {
+        carry += dlimb_type(ap[i]) * b + rp[i];
+        rp[i] = limb_type(carry);
+        carry >>= LIMB_BITS;
+    }
+    return limb_type(carry);
+}
+limb_type submul_1(limb_type *rp, const limb_type *ap, size_type n, limb_type b) noexcept
+{
+    dlimb_type carry = 0;
+    for(size_type i = 0; i < n; ++i)
+    {
+        carry += dlimb_type(ap[i]) * b;
+        limb_type lo = limb_type(carry), r = rp[i];
+        carry >>= LIMB_BITS;
+        carry += (r < lo);
+        rp[i] = r - lo;
+    }
+    return limb_type(carry);
+}
+
+static void mul_basecase(limb_type *rp, const limb_type *ap, size_type an,
+                         const limb_type *bp, size_type bn) noexcept
+{
+    rp[an] = mul_1(rp, ap, an, bp[0]);
+    for(size_type i = 1; i < bn; ++i)
+        rp[an + i] = addmul_1(rp + i, ap, an, bp[i]);
+}
+static void sqr_basecase(limb_type *rp, const limb_type *ap, size_type n) noexcept
+{
+    // sum of ap[i] * ap[j] with i < j, doubled, plus the squares ap[i]^2
+    std::fill(rp, rp + 2 * n, limb_type(0));
+    for(size_type i = 0; i + 1 < n; ++i)
+        rp[i + n] = addmul_1(rp + 2 * i + 1, ap + i + 1, n - i - 1, ap[i]);
+    lshift(rp, rp, 2 * n, 1);
+    dlimb_type carry = 0;
+    for(size_type i = 0; i < n; ++i)
+    {
+        dlimb_type sq = dlimb_type(ap[i]) * ap[i];
+        carry += dlimb_type(rp[2 * i]) + limb_type(sq);
+        rp[2 * i] = limb_type(carry);
+        carry >>= LIMB_BITS;
+        carry += dlimb_type(rp[2 * i + 1]) + (sq >> LIMB_BITS);
+        rp[2 * i + 1] = limb_type(carry);
+        carry >>= LIMB_BITS;
+    }
+}
+
+// Karatsuba, a = a1 * B^m + a0, b = b1 * B^m + b0,
+// a * b = a1b1 * B^2m + ((a0+a1)(b0+b1) - a0b0 - a1b1) * B^m + a0b0
+// (rp, 2m) holds a0b0, (rp + 2m, z2n) holds a1b1, (pr, 2m + 2) holds
+// (a0+a1)(b0+b1), and rn is the size of the product
+static void karatsuba_fold(limb_type *rp, size_type rn, limb_type *pr,
+                           size_type m, size_type z2n) noexcept
+{
+    limb_type borrow = sub(pr, pr, 2 * m + 2, rp, 2 * m);
+    borrow |= sub(pr, pr, 2 * m + 2, rp + 2 * m, z2n);
+    assert(borrow == 0);
+    limb_type carry = add(rp + m, rp + m, rn - m, pr, normalize(pr, 2 * m + 2));
+    assert(carry == 0);
+    static_cast<void>(borrow), static_cast<void>(carry);
+}
+size_type mul_n_itch(size_type n) noexcept
+{
+    size_type s = 0;
+    for(; n >= MUL_KARATSUBA_THRESHOLD; n = (n + 1) / 2 + 1)
+        s += 4 * ((n + 1) / 2) + 4;
+    return s;
+}
+void mul_n(limb_type *rp, const limb_type *ap, const limb_type *bp,
+           size_type n, limb_type *ws) noexcept
+{
+    if(n < MUL_KARATSUBA_THRESHOLD)
+        return mul_basecase(rp, ap, n, bp, n);
+    size_type m = (n + 1) / 2, h = n - m;
+    mul_n(rp, ap, bp, m, ws);
+    mul_n(rp + 2 * m, ap + m, bp + m, h, ws);
+    limb_type *sa = ws, *sb = sa + m + 1, *pr = sb + m + 1;
+    sa[m] = add(sa, ap, m, ap + m, h);
+    sb[m] = add(sb, bp, m, bp + m, h);
+    mul_n(pr, sa, sb, m + 1, pr + 2 * m + 2);
+    karatsuba_fold(rp, 2 * n, pr, m, 2 * h);
+}
+void sqr_n(limb_type *rp, const limb_type *ap, size_type n, limb_type *ws) noexcept
+{
+    if(n < MUL_KARATSUBA_THRESHOLD)
+        return sqr_basecase(rp, ap, n);
+    size_type m = (n + 1) / 2, h = n - m;
+    sqr_n(rp, ap, m, ws);
+    sqr_n(rp + 2 * m, ap + m, h, ws);
+    limb_type *sa = ws, *pr = sa + m + 1;
+    sa[m] = add(sa, ap, m, ap + m, h);
+    sqr_n(pr, sa, m + 1, pr + 2 * m + 2);
+    karatsuba_fold(rp, 2 * n, pr, m, 2 * h);
+}
+
+void mul(limb_type *rp, const limb_type *ap, size_type an,
+         const limb_type *bp, size_type bn)
+{
+    if(bn < MUL_KARATSUBA_THRESHOLD)
+        return mul_basecase(rp, ap, an, bp, bn);
+    if(an == bn)
+    {
+        std::vector<limb_type> ws(mul_n_itch(an));
+        return mul_n(rp, ap, bp, an, ws.data());
+    }
+
+    size_type m = (an + 1) / 2;
+    if(bn <= m)
+    {
+        // unbalanced, multiply b by each bn limbs of a
+        mul(rp, ap, bn, bp, bn);
+        std::vector<limb_type> t(2 * bn);
+        for(size_type i = bn; i < an; i += bn)
+        {
+            size_type len = std::min(bn, an - i);
+            if(len == bn) mul(t.data(), ap + i, len, bp, bn);
+            else mul(t.data(), bp, bn, ap + i, len);
+            std::copy(t.begin() + bn, t.begin() + bn + len, rp + i + bn);
+            limb_type carry = add_n(rp + i, rp + i, t.data(), bn);
+            carry = add_1(rp + i + bn, rp + i + bn, len, carry);
+            assert(carry == 0);
+        }
+        return;
+    }
+
+    // Karatsuba with a1 longer than b1
+    size_type a1n = an - m, b1n = bn - m;
+    std::vector<limb_type> ws(4 * m + 4 + mul_n_itch(m + 1));
+    mul_n(rp, ap, bp, m, ws.data());
+    mul(rp + 2 * m, ap + m, a1n, bp + m, b1n);
+    limb_type *sa = ws.data(), *sb = sa + m + 1, *pr = sb + m + 1;
+    sa[m] = add(sa, ap, m, ap + m, a1n);
+    sb[m] = add(sb, bp, m, bp + m, b1n);
+    mul_n(pr, sa, sb, m + 1, pr + 2 * m + 2);
+    karatsuba_fold(rp, an + bn, pr, m, a1n + b1n);
+}
+void sqr(limb_type *rp, const limb_type *ap, size_type n)
+{
+    if(n < MUL_KARATSUBA_THRESHOLD)
+        return sqr_basecase(rp, ap, n);
+    std::vector<limb_type> ws(mul_n_itch(n));
+    sqr_n(rp, ap, n, ws.data());
+}
+
+limb_type divrem_1(limb_type *qp, const limb_type *ap, size_type n, limb_type d) noexcept
+{
+    dlimb_type r = 0;
+    for(size_type i = n - 1; i != (size_type)-1; --i)
+    {
+        r = (r << LIMB_BITS) | ap[i];
+        qp[i] = limb_type(r / d);
+        r %= d;
+    }
+    return limb_type(r);
+}
+limb_type mod_1(const limb_type *ap, size_type n, limb_type d) noexcept
+{
+    dlimb_type r = 0;
+    for(size_type i = n - 1; i != (size_type)-1; --i)
+        r = ((r << LIMB_BITS) | ap[i]) % d;
+    return limb_type(r);
+}
+void divrem(limb_type *qp, limb_type *rp, const limb_type *ap, size_type an,
+            const limb_type *dp, size_type dn)
+{
+    if(dn == 1)
+    {
+        rp[0] = qp ? divrem_1(qp, ap, an, dp[0]) : mod_1(ap, an, dp[0]);
+        return;
+    }
+    std::vector<limb_type> ws(divrem_itch(an, dn));
+    divrem(qp, rp, ap, an, dp, dn, ws.data());
+}
+size_type divrem_itch(size_type an, size_type dn) noexcept
+{ return an + 1 + dn; }
+void divrem(limb_type *qp, limb_type *rp, const limb_type *ap, size_type an,
+            const limb_type *dp, size_type dn, limb_type *ws) noexcept
+{
+    if(dn == 1)
+    {
+        rp[0] = qp ? divrem_1(qp, ap, an, dp[0]) : mod_1(ap, an, dp[0]);
+        return;
+    }
+
+    // implement the algorithm in Knuth[The Art of Computer Programming],
+    // working on normalized copies, so the outputs may overlap the inputs
+    // 1. normalize
+    unsigned s = 0;
+    for(limb_type top = dp[dn-1]; !(top >> (LIMB_BITS - 1)); top <<= 1) ++s;
+    limb_type *u = ws, *v = u + an + 1;
+    u[an] = lshift(u, ap, an, s);
+    lshift(v, dp, dn, s);
+
+    // 2. loop
+    const dlimb_type base = dlimb_type(1) << LIMB_BITS;
+    const limb_type v1 = v[dn-1], v2 = v[dn-2];
+    for(size_type j = an - dn; j != (size_type)-1; --j)
+    {
+        // get the estimated value of q, it is at most one too large
+        dlimb_type num = (dlimb_type(u[j+dn]) << LIMB_BITS) | u[j+dn-1];
+        dlimb_type qh = num / v1, rh = num % v1;
+        while(qh >= base || qh * v2 > ((rh << LIMB_BITS) | u[j+dn-2]))
+        {
+            --qh, rh += v1;
+            if(rh >= base) break;
+        }
+
+        // multi and subtract, add the divisor back if it is too large
+        limb_type borrow = submul_1(u + j, v, dn, limb_type(qh));
+        limb_type top = u[j+dn];
+        u[j+dn] = top - borrow;
+        if(top < borrow)
+        {
+            --qh;
+            u[j+dn] += add_n(u + j, u + j, v, dn);
+        }
+        if(qp) qp[j] = limb_type(qh);
+    }
+    // 3. get the real remainder
+    rshift(rp, u, dn, s);
+}
+
+limb_type mont_inverse(limb_type m0) noexcept
+{
+    // Newton's iteration, each step doubles the number of correct bits
+    limb_type inv = m0; // m0 * m0 == 1 mod 8
+    for(int i = 0; i < 4; ++i)
+        inv *= 2 - m0 * inv;
+    return limb_type(0) - inv;
+}
+void redc(limb_type *rp, limb_type *tp, const limb_type *mp, size_type n,
+          limb_type minv) noexcept
+{
+    // make tp[i] zero by adding a multiple of mp, and keep the carry there,
+    // the carries are added to the high half at the end
+    for(size_type i = 0; i < n; ++i)
+        tp[i] = addmul_1(tp + i, mp, n, tp[i] * minv);
+    limb_type carry = add_n(rp, tp + n, tp, n);
+    if(carry || cmp(rp, mp, n) >= 0)
+        sub_n(rp, rp, mp, n);
+}
+
+#ifdef __SIZEOF_INT128__
+static inline uint64_t load64(const limb_type *p) noexcept
+{ return p[0] | (uint64_t(p[1]) << 32); }
+static inline void store64(limb_type *p, uint64_t v) noexcept
+{ p[0] = limb_type(v), p[1] = limb_type(v >> 32); }
+
+// Montgomery multiplication on n 64-bit words (CIOS), which needs a quarter
+// of the multiplications of 32-bit limbs, tp has n + 2 words
+static void mont_mul64(limb_type *rp, const limb_type *ap, const limb_type *bp,
+                       const limb_type *mp, size_type n, limb_type minv,
+                       limb_type *tp) noexcept
+{
+    using word  = uint64_t;
+    using dword = unsigned __int128;
+
+    // lift -1/m mod 2^32 to -1/m mod 2^64 by one more Newton step
+    word m0 = load64(mp), inv = limb_type(0) - minv;
+    inv *= 2 - m0 * inv;
+    word winv = word(0) - inv;
+
+    std::fill(tp, tp + 2 * n + 4, limb_type(0));
+    for(size_type i = 0; i < n; ++i)
+    {
+        // tp += ap * bp[i]
+        word b = load64(bp + 2 * i);
+        dword c = 0;
+        for(size_type j = 0; j < n; ++j)
+        {
+            c += dword(load64(ap + 2 * j)) * b + load64(tp + 2 * j);
+            store64(tp + 2 * j, word(c));
+            c >>= 64;
+        }
+        c += load64(tp + 2 * n);
+        store64(tp + 2 * n, word(c));
+        store64(tp + 2 * n + 2, word(c >> 64));
+        // tp = (tp + u * mp) / 2^64
+        word t0 = load64(tp), u = t0 * winv;
+        c = (dword(u) * m0 + t0) >> 64;
+        for(size_type j = 1; j < n; ++j)
+        {
+            c += dword(u) * load64(mp + 2 * j) + load64(tp + 2 * j);
+            store64(tp + 2 * j - 2, word(c));
+            c >>= 64;
+        }
+        c += load64(tp + 2 * n);
+        store64(tp + 2 * n - 2, word(c));
+        store64(tp + 2 * n, load64(tp + 2 * n + 2) + word(c >> 64));
+    }
+    // the result is less than 2 * mp
+    if(load64(tp + 2 * n) || cmp(tp, mp, 2 * n) >= 0)
+        sub_n(rp, tp, mp, 2 * n);
+    else std::copy(tp, tp + 2 * n, rp);
+}
+#endif
+
+size_type mont_size(size_type n) noexcept
+{
+#ifdef __SIZEOF_INT128__
+    return (n + 1) / 2 * 2;
+#else
+    return n;
+#endif
+}
+size_type mont_mul_itch(size_type n) noexcept
+{ return 2 * n + 4 + mul_n_itch(n); }
+void mont_mul(limb_type *rp, const limb_type *ap, const limb_type *bp,
+              const limb_type *mp, size_type n, limb_type minv, limb_type *tp) noexcept
+{
+#ifdef __SIZEOF_INT128__
+    if(n % 2 == 0)
+        return mont_mul64(rp, ap, bp, mp, n / 2, minv, tp);
+#endif
+    if(ap == bp) sqr_n(tp, ap, n, tp + 2 * n);
+    else mul_n(tp, ap, bp, n, tp + 2 * n);
+    redc(rp, tp, mp, n, minv);
+}
+
+// window size of the sliding window exponentiation
+static unsigned pow_window(size_type bits) noexcept
+{
+    return bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 7 ? 2 : 1;
+}
+static bool test_bit(const limb_type *ep, size_type i) noexcept
+{ return (ep[i / LIMB_BITS] >> (i % LIMB_BITS)) & 1; }
+
+// (rp, n) = x^(ep, en) with the multiplication mulmod(rp, ap, bp) on n words,
+// table holds x, x^3, x^5, ... x^(2^k - 1) where k = pow_window(bits of e)
+template<typename Word, typename MulMod>
+static void window_pow(Word *rp, const limb_type *ep, size_type en,
+                       size_type n, Word *table, MulMod &mulmod)
+{
+    size_type bits = en * LIMB_BITS;
+    while(!test_bit(ep, bits - 1)) --bits;
+    unsigned k = pow_window(bits);
+    if(k > 1)
+    {
+        mulmod(rp, table, table); // x^2
+        for(size_type i = 1; i < (size_type(1) << (k - 1)); ++i)
+            mulmod(table + i * n, table + (i - 1) * n, rp);
+    }
+
+    bool first = true;
+    for(size_type i = bits - 1; i != (size_type)-1; )
+    {
+        if(!test_bit(ep, i))
+        {
+            mulmod(rp, rp, rp);
+            --i;
+            continue;
+        }
+        // the longest window ep[i..l] with at most k bits and ep[l] == 1
+        size_type l = (i + 1 > k) ? i + 1 - k : 0;
+        while(!test_bit(ep, l)) ++l;
+        size_type val = 0;
+        for(size_type j = i; j != l - 1; --j)
+            val = val * 2 + test_bit(ep, j);
+        const Word *xp = table + (val >> 1) * n;
+        if(first)
+            std::copy(xp, xp + n, rp), first = false;
+        else
+        {
+            for(size_type j = l; j <= i; ++j)
+                mulmod(rp, rp, rp);
+            mulmod(rp, rp, xp);
+        }
+        i = l - 1;
+    }
+}
+
+namespace {
+
+struct mont_mulmod {
+    const limb_type *mp;
+    size_type n;
+    limb_type minv;
+    limb_type *tp; // mont_mul_itch(n) limbs
+
+    void operator()(limb_type *rp, const limb_type *ap, const limb_type *bp) noexcept
+    { mont_mul(rp, ap, bp, mp, n, minv, tp); }
+};
+
+struct plain_mulmod {
+    const limb_type *mp;
+    size_type n;
+    limb_type *tp; // plain_mul_itch(n) limbs
+
+    // 2n limbs for the product, then the scratch of the product and the
+    // reduction, which are used one after the other
+    static size_type plain_mul_itch(size_type n) noexcept
+    { return 2 * n + std::max(mul_n_itch(n), divrem_itch(2 * n, n)); }
+
+    void operator()(limb_type *rp, const limb_type *ap, const limb_type *bp) noexcept
+    {
+        if(ap == bp) sqr_n(tp, ap, n, tp + 2 * n);
+        else mul_n(tp, ap, bp, n, tp + 2 * n);
+        divrem(nullptr, rp, tp, 2 * n, mp, n, tp + 2 * n);
+    }
+};
+
+} // namespace
+
+void powm(limb_type *rp, const limb_type *bp, size_type bn,
+          const limb_type *ep, size_type en, const limb_type *mp, size_type n)
+{
+    en = normalize(ep, en);
+    bn = normalize(bp, bn);
+    if(en == 0 || bn == 0 || (n == 1 && mp[0] == 1))
+    {
+        std::fill(rp, rp + n, limb_type(0));
+        if(en == 0 && !(n == 1 && mp[0] == 1)) rp[0] = 1;
+        return;
+    }
+
+    // All the buffers are allocated once: the table, the result, the
+    // scratch, the modulus in case rp overlaps it, and the base.
+    // For odd modulus, the numbers are kept in Montgomery form x * R mod m
+    // on w = mont_size(n) limbs, where R = B^w.
+    bool odd = (mp[0] & 1);
+    size_type w = odd ? mont_size(n) : n, pad = odd ? w : 0;
+    size_type bits = en * LIMB_BITS;
+    while(!test_bit(ep, bits - 1)) --bits;
+    size_type tn = (size_type(1) << (pow_window(bits) - 1)) * w;
+    // the scratch also serves the reduction of the base before the powering
+    size_type itch = odd ? mont_mul_itch(w) : plain_mulmod::plain_mul_itch(n);
+    itch = std::max(itch, divrem_itch(pad + bn, n));
+    std::vector<limb_type> buf(tn + w + itch + w + pad + bn);
+    limb_type *table = buf.data(), *r = table + tn, *tp = r + w;
+    limb_type *m = tp + itch, *x = m + w;
+    std::copy(mp, mp + n, m);
+    std::fill(m + n, m + w, limb_type(0));
+
+    // table[0] = b * R mod m
+    std::fill(x, x + pad, limb_type(0));
+    std::copy(bp, bp + bn, x + pad);
+    size_type xn = pad + bn;
+    if(xn >= n) divrem(nullptr, table, x, xn, m, n, tp);
+    else std::copy(x, x + xn, table), std::fill(table + xn, table + n, limb_type(0));
+    std::fill(table + n, table + w, limb_type(0));
+
+    if(!odd)
+    {
+        plain_mulmod mulmod{m, n, tp};
+        window_pow(r, ep, en, n, table, mulmod);
+        std::copy(r, r + n, rp);
+        return;
+    }
+    mont_mulmod mulmod{m, w, mont_inverse(m[0]), tp};
+    window_pow(r, ep, en, w, table, mulmod);
+    // convert back, r * R^-1 mod m, the table is free now
+    std::fill(table, table + w, limb_type(0));
+    table[0] = 1;
+    mulmod(r, r, table);
+    std::copy(r, r + n, rp);
+}
+
+limb_type lshift(limb_type *rp, const limb_type *ap, size_type n, unsigned cnt) noexcept
+{
+    if(cnt == 0)
+    {
+        if(rp != ap) std::memmove(rp, ap, n * sizeof(limb_type));
+        return 0;
+    }
+    unsigned rcnt = LIMB_BITS - cnt;
+    limb_type out = ap[n-1] >> rcnt;
+    for(size_type i = n - 1; i > 0; --i)
+        rp[i] = (ap[i] << cnt) | (ap[i-1] >> rcnt);
+    rp[0] = ap[0] << cnt;
+    return out;
+}
+limb_type rshift(limb_type *rp, const limb_type *ap, size_type n, unsigned cnt) noexcept
+{
+    if(cnt == 0)
+    {
+        if(rp != ap) std::memmove(rp, ap, n * sizeof(limb_type));
+        return 0;
+    }
+    unsigned lcnt = LIMB_BITS - cnt;
+    limb_type out = ap[0] << lcnt;
+    for(size_type i = 0; i + 1 < n; ++i)
+        rp[i] = (ap[i] >> cnt) | (ap[i+1] << lcnt);
+    rp[n-1] = ap[n-1] >> cnt;
+    return out;
+}
+
+size_type popcount(const limb_type *ap, size_type n) noexcept
+{
+    // two limbs at a time, which is one instruction on 64-bit platforms
+    size_type cnt = 0, i = 0;
+#if defined(__GNUC__)
+    for(; i + 1 < n; i += 2)
+        cnt += __builtin_popcountll(ap[i] | (uint64_t(ap[i+1]) << LIMB_BITS));
+#endif
+    for(; i < n; ++i)
+        cnt += popcount(ap[i]);
+    return cnt;
+}
+
+namespace {
+
+const uint64_t HASH_SECRET[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+    0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+// the high and low halves of the 128-bit product a * b, xored
+inline uint64_t mum(uint64_t a, uint64_t b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return uint64_t(r) ^ uint64_t(r >> 64);
+#else
+    uint64_t al = uint32_t(a), ah = a >> 32, bl = uint32_t(b), bh = b >> 32;
+    uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    uint64_t mid = (ll >> 32) + uint32_t(lh) + uint32_t(hl);
+    uint64_t lo = (mid << 32) | uint32_t(ll);
+    uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return lo ^ hi;
+#endif
+}
+
+inline uint64_t word(const limb_type *p) noexcept
+{ return p[0] | (uint64_t(p[1]) << LIMB_BITS); }
+
+} // namespace
+
+uint64_t hash(const limb_type *ap, size_type n, uint64_t seed) noexcept
+{
+    static_assert(LIMB_BITS == 32, "hash reads two limbs as a 64-bit word");
+    const uint64_t *s = HASH_SECRET;
+    uint64_t h = seed ^ mum(seed ^ s[0], s[1]);
+    size_type i = 0;
+    // 16 limbs at a time in four independent lanes, so that the multiplies
+    // of a long number overlap in the pipeline
+    if(n >= 16)
+    {
+        uint64_t h1 = h, h2 = h, h3 = h;
+        for(; i + 16 <= n; i += 16)
+        {
+            h  = mum(word(ap + i)      ^ s[0], word(ap + i + 2)  ^ h);
+            h1 = mum(word(ap + i + 4)  ^ s[1], word(ap + i + 6)  ^ h1);
+            h2 = mum(word(ap + i + 8)  ^ s[2], word(ap + i + 10) ^ h2);
+            h3 = mum(word(ap + i + 12) ^ s[3], word(ap + i + 14) ^ h3);
+        }
+        h ^= h1 ^ mum(h2, h3 ^ s[0]);
+    }
+    for(; i + 4 <= n; i += 4)
+        h = mum(word(ap + i) ^ s[1], word(ap + i + 2) ^ h);
+    uint64_t a = 0, b = 0;
+    if(i + 2 <= n) a = word(ap + i), i += 2;
+    if(i < n) b = ap[i];
+    h = mum(a ^ s[1], b ^ h);
+    return mum(h ^ s[0] ^ uint64_t(n), s[1] ^ uint64_t(n));
+}
+
+} // namespace mpn
+
+} // namespace kedixa
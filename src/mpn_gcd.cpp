@@ -0,0 +1,747 @@
+#include "kedixa/mpn.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace kedixa {
+
+namespace mpn {
+
+// number of trailing zero bits of x != 0
+static unsigned ctz64(uint64_t x) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    unsigned cnt = 0;
+    for(; !(x & 1); x >>= 1) ++cnt;
+    return cnt;
+#endif
+}
+// binary GCD of two 64-bit numbers
+static uint64_t gcd_64(uint64_t a, uint64_t b) noexcept
+{
+    if(a == 0 || b == 0) return a | b;
+    unsigned k = ctz64(a | b);
+    a >>= ctz64(a);
+    do {
+        b >>= ctz64(b);
+        if(a > b) std::swap(a, b);
+        b -= a;
+    } while(b);
+    return a << k;
+}
+// (rp, n + 2) = (ap, n) * c
+static void mul_2(limb_type *rp, const limb_type *ap, size_type n, uint64_t c) noexcept
+{
+    rp[n] = mul_1(rp, ap, n, limb_type(c));
+    rp[n+1] = addmul_1(rp + 1, ap, n, limb_type(c >> LIMB_BITS));
+}
+// (ap, an) >> (32 * (n - 3) + s), where the result has at most 64 bits,
+// n >= 3 and the limbs of ap above an are read as zero
+static uint64_t top_bits(const limb_type *ap, size_type an, size_type n, unsigned s) noexcept
+{
+    limb_type hi  = n - 1 < an ? ap[n-1] : 0;
+    limb_type mid = n - 2 < an ? ap[n-2] : 0;
+    limb_type lo  = ap[n-3];
+    return (uint64_t(hi) << (64 - s)) | (((uint64_t(mid) << LIMB_BITS) | lo) >> s);
+}
+
+namespace {
+
+// The cofactors of a, the first operand, for the remainders of Euclid's
+// algorithm on (a, b). For the current pair (x, y),
+// x = sign * u0 * a (mod b) and y = -sign * u1 * a (mod b), the cofactors
+// of two consecutive remainders have opposite signs. They are not greater
+// than b, so u0 and u1 have at most bn + 1 limbs, the products before
+// normalization have a few more.
+struct cofactors {
+    size_type n;        // u0 and u1 have n limbs, the rest are zero
+    int sign;
+    limb_type *u0, *u1, *w0, *w1;
+    std::vector<limb_type> buf;
+
+    explicit cofactors(size_type bn) : n(1), sign(1), buf(6 * (bn + 3), 0)
+    {
+        u0 = buf.data(), u1 = u0 + bn + 3;
+        w0 = u1 + bn + 3, w1 = w0 + 2 * (bn + 3);
+        u0[0] = 1;
+    }
+    cofactors(const cofactors&) = delete;
+    cofactors& operator=(const cofactors&) = delete;
+
+    // (x, y) = (y, x)
+    void swap() noexcept
+    {
+        std::swap(u0, u1);
+        sign = -sign;
+    }
+    // x -= q * y, so u0 += q * u1
+    void add_q(const limb_type *qp, size_type qn)
+    {
+        size_type vn = normalize(u1, n);
+        qn = normalize(qp, qn);
+        if(vn == 0 || qn == 0) return;
+        if(qn >= vn) mul(w0, qp, qn, u1, vn);
+        else mul(w0, u1, vn, qp, qn);
+        size_type tn = qn + vn, rn = std::max(tn, n);
+        limb_type cy = tn >= n ? add(u0, w0, tn, u0, n) : add(u0, u0, n, w0, tn);
+        if(cy) u0[rn++] = cy;
+        n = std::max(n, normalize(u0, rn));
+    }
+    // the step of Lehmer's algorithm, (x, y) = ((-1)^k (s0 x - t0 y),
+    // (-1)^(k+1) (s1 x - t1 y))
+    void lehmer(uint64_t s0, uint64_t t0, uint64_t s1, uint64_t t1, size_type k)
+    {
+        mul_2(w0, u0, n, s0);
+        mul_2(w1, u1, n, t0);
+        add_n(w0, w0, w1, n + 2);
+        mul_2(w1, u0, n, s1);
+        std::copy(w0, w0 + n + 2, u0);
+        mul_2(w0, u1, n, t1);
+        add_n(u1, w1, w0, n + 2);
+        n = std::max(normalize(u0, n + 2), normalize(u1, n + 2));
+        if(k % 2) sign = -sign;
+    }
+};
+
+} // namespace
+
+// the gcd by Lehmer's algorithm, like gcd, and the cofactors are updated
+// if c is not nullptr
+static size_type gcd_lehmer(limb_type *rp, limb_type *ap, size_type an,
+                            limb_type *bp, size_type bn, cofactors *c)
+{
+    // Lehmer's algorithm: the quotients of Euclid's algorithm are computed
+    // from the leading 62 bits of a and b, and are applied to the whole
+    // numbers at once as a matrix of 64-bit cofactors, where
+    // r_i = (-1)^i (s_i * a - t_i * b) for the remainders r_0 = a, r_1 = b
+    an = normalize(ap, an);
+    bn = normalize(bp, bn);
+    size_type maxn = std::max(an, bn);
+    std::vector<limb_type> buf(3 * (maxn + 2));
+    limb_type *xp = buf.data(), *yp = xp + maxn + 2, *qp = yp + maxn + 2;
+    while(true)
+    {
+        if(an < bn || (an == bn && cmp(ap, bp, an) < 0))
+        {
+            std::swap(ap, bp), std::swap(an, bn);
+            if(c) c->swap();
+        }
+        if(bn == 0)
+        {
+            std::copy(ap, ap + an, rp);
+            return an;
+        }
+        if(an <= 2)
+        {
+            uint64_t a = ap[0] | (an > 1 ? uint64_t(ap[1]) << LIMB_BITS : 0);
+            uint64_t b = bp[0] | (bn > 1 ? uint64_t(bp[1]) << LIMB_BITS : 0);
+            uint64_t g;
+            if(c)
+            {
+                // Euclid's algorithm, the binary one has no cofactors
+                while(b)
+                {
+                    uint64_t q = a / b, r = a % b;
+                    qp[0] = limb_type(q), qp[1] = limb_type(q >> LIMB_BITS);
+                    c->add_q(qp, 2);
+                    c->swap();
+                    a = b, b = r;
+                }
+                g = a;
+            }
+            else g = gcd_64(a, b);
+            rp[0] = limb_type(g);
+            if(g >> LIMB_BITS) rp[1] = limb_type(g >> LIMB_BITS);
+            return (g >> LIMB_BITS) ? 2 : 1;
+        }
+
+        size_type steps = 0;
+        uint64_t s0 = 1, t0 = 0, s1 = 0, t1 = 1;
+        if(an <= bn + 1)
+        {
+            unsigned c = 0;
+            for(limb_type top = ap[an-1]; !(top >> (LIMB_BITS - 1)); top <<= 1) ++c;
+            uint64_t ah = top_bits(ap, an, an, 34 - c), bh = top_bits(bp, bn, an, 34 - c);
+            // a / 2^k is in [ah, ah + 1) and b / 2^k in [bh, bh + 1), run
+            // Euclid's algorithm on the corners (ah, bh + 1) and (ah + 1, bh)
+            // of the box, where each remainder takes its minimum and maximum,
+            // while both give the same quotient it is the true one
+            int64_t pa = ah, pb = bh + 1, qa = ah + 1, qb = bh;
+            while(pb > 0 && qb > 0)
+            {
+                int64_t q = pa / pb;
+                if(q != qa / qb) break;
+                int64_t r = pa - q * pb;
+                pa = pb, pb = r;
+                r = qa - q * qb;
+                qa = qb, qb = r;
+                uint64_t s = s0 + q * s1, t = t0 + q * t1;
+                s0 = s1, s1 = s, t0 = t1, t1 = t;
+                ++steps;
+            }
+        }
+        if(steps == 0)
+        {
+            // a / b is too large, take a full division step
+            divrem(c ? qp : nullptr, ap, ap, an, bp, bn);
+            if(c) c->add_q(qp, an - bn + 1);
+            an = normalize(ap, bn);
+            continue;
+        }
+
+        // (a, b) = (r_steps, r_steps+1), both not greater than the old b
+        size_type n = an + 2;
+        mul_2(xp, ap, an, s0);
+        mul_2(yp, bp, bn, t0);
+        std::fill(yp + bn + 2, yp + n, limb_type(0));
+        if(steps % 2 == 0) sub_n(xp, xp, yp, n);
+        else sub_n(xp, yp, xp, n);
+        mul_2(yp, ap, an, s1);
+        std::copy(xp, xp + bn, ap);
+        mul_2(xp, bp, bn, t1);
+        std::fill(xp + bn + 2, xp + n, limb_type(0));
+        if(steps % 2 == 1) sub_n(yp, yp, xp, n);
+        else sub_n(yp, xp, yp, n);
+        std::copy(yp, yp + bn, bp);
+        if(c) c->lehmer(s0, t0, s1, t1, steps);
+        an = normalize(ap, bn);
+        bn = normalize(bp, bn);
+    }
+}
+
+
+// Half GCD, following Moller [On Schonhage's algorithm and subquadratic
+// integer GCD computation] and the layout of GMP. A reduction of (a, b) is
+// kept as a matrix M of natural numbers with determinant 1, such that
+// (a; b) = M (alpha; beta), then (alpha; beta) = M^-1 (a; b) where
+// M^-1 = (m11, -m01; -m10, m00). Reducing a by q * b multiplies M from
+// the right by (1, q; 0, 1), that is column 1 += q * column 0, and
+// reducing b by q * a adds q * column 1 to column 0.
+namespace {
+
+struct hgcd_matrix {
+    size_type alloc;    // the room of each entry
+    size_type n;        // the entries have n limbs, the rest are zero
+    limb_type *p[2][2];
+    std::vector<limb_type> buf;
+
+    // the identity, big enough for hgcd on n limbs
+    explicit hgcd_matrix(size_type size)
+        : alloc((size + 1) / 2 + 1), n(1), buf(4 * alloc, 0)
+    {
+        for(int i = 0; i < 2; ++i)
+            for(int j = 0; j < 2; ++j)
+                p[i][j] = buf.data() + (2 * i + j) * alloc;
+        p[0][0][0] = p[1][1][0] = 1;
+    }
+    hgcd_matrix(const hgcd_matrix&) = delete;
+    hgcd_matrix& operator=(const hgcd_matrix&) = delete;
+};
+
+// a matrix with entries less than B / 2, from hgcd2
+struct hgcd_matrix1 {
+    limb_type u[2][2];
+};
+
+} // namespace
+
+// Reduce the double limb numbers (a, b) while both and their difference
+// are at least 2^(LIMB_BITS + 1), return false if nothing can be done.
+// Then the entries of M are less than B / 2, and M^-1 applied to the whole
+// numbers, which a and b are the leading limbs of, keeps them positive.
+static bool hgcd2(dlimb_type a, dlimb_type b, hgcd_matrix1 &M) noexcept
+{
+    const dlimb_type LIMIT = dlimb_type(1) << (LIMB_BITS + 1);
+    dlimb_type u00, u01, u10, u11;
+    if(a < LIMIT || b < LIMIT)
+        return false;
+    if(a > b)
+    {
+        a -= b;
+        if(a < LIMIT) return false;
+        u00 = u01 = u11 = 1, u10 = 0;
+    }
+    else
+    {
+        b -= a;
+        if(b < LIMIT) return false;
+        u00 = u10 = u11 = 1, u01 = 0;
+    }
+
+    // each reduction subtracts once first, and then divides, and the
+    // quotient is decreased by one if the remainder would be too small
+    while(true)
+    {
+        if(a >= b)
+        {
+            a -= b;
+            if(a < LIMIT) break;
+            dlimb_type q = 1;
+            if(a > b)
+            {
+                q = a / b + 1, a %= b;
+                if(a < LIMIT)
+                {
+                    --q;
+                    u01 += q * u00, u11 += q * u10;
+                    break;
+                }
+            }
+            u01 += q * u00, u11 += q * u10;
+        }
+        else
+        {
+            b -= a;
+            if(b < LIMIT) break;
+            dlimb_type q = 1;
+            if(b > a)
+            {
+                q = b / a + 1, b %= a;
+                if(b < LIMIT)
+                {
+                    --q;
+                    u00 += q * u01, u10 += q * u11;
+                    break;
+                }
+            }
+            u00 += q * u01, u10 += q * u11;
+        }
+    }
+    assert(std::max(std::max(u00, u01), std::max(u10, u11)) < (dlimb_type(1) << (LIMB_BITS - 1)));
+    M.u[0][0] = limb_type(u00), M.u[0][1] = limb_type(u01);
+    M.u[1][0] = limb_type(u10), M.u[1][1] = limb_type(u11);
+    return true;
+}
+
+// (rp; bp) = (u00 a + u10 b; u01 a + u11 b), both have room for n + 1
+// limbs, return the new size
+static size_type matrix1_mul_vector(const hgcd_matrix1 &M, limb_type *rp,
+                                    const limb_type *ap, limb_type *bp, size_type n) noexcept
+{
+    limb_type ah = mul_1(rp, ap, n, M.u[0][0]);
+    ah += addmul_1(rp, bp, n, M.u[1][0]);
+    limb_type bh = mul_1(bp, bp, n, M.u[1][1]);
+    bh += addmul_1(bp, ap, n, M.u[0][1]);
+    rp[n] = ah, bp[n] = bh;
+    return n + ((ah | bh) != 0);
+}
+// (rp; bp) = M^-1 (a; b) = (u11 a - u01 b; u00 b - u10 a), return the
+// new size
+static size_type matrix1_inverse_mul_vector(const hgcd_matrix1 &M, limb_type *rp,
+                                            const limb_type *ap, limb_type *bp,
+                                            size_type n) noexcept
+{
+    limb_type h0 = mul_1(rp, ap, n, M.u[1][1]);
+    limb_type h1 = submul_1(rp, bp, n, M.u[0][1]);
+    assert(h0 == h1);
+    h0 = mul_1(bp, bp, n, M.u[0][0]);
+    h1 = submul_1(bp, ap, n, M.u[1][0]);
+    assert(h0 == h1);
+    static_cast<void>(h0), static_cast<void>(h1);
+    return n - ((rp[n-1] | bp[n-1]) == 0);
+}
+
+// M = M * M1, tp has M.n limbs
+static void matrix_mul_1(hgcd_matrix &M, const hgcd_matrix1 &M1, limb_type *tp) noexcept
+{
+    std::copy(M.p[0][0], M.p[0][0] + M.n, tp);
+    size_type n0 = matrix1_mul_vector(M1, M.p[0][0], tp, M.p[0][1], M.n);
+    std::copy(M.p[1][0], M.p[1][0] + M.n, tp);
+    size_type n1 = matrix1_mul_vector(M1, M.p[1][0], tp, M.p[1][1], M.n);
+    M.n = std::max(n0, n1);
+    assert(M.n < M.alloc);
+}
+
+// column col of M += (qp, qn) * column 1 - col, tp has qn + M.n limbs
+static void matrix_update_q(hgcd_matrix &M, const limb_type *qp, size_type qn,
+                            unsigned col, limb_type *tp)
+{
+    if(qn == 1)
+    {
+        limb_type q = qp[0];
+        limb_type c0 = addmul_1(M.p[0][col], M.p[0][1-col], M.n, q);
+        limb_type c1 = addmul_1(M.p[1][col], M.p[1][1-col], M.n, q);
+        M.p[0][col][M.n] = c0, M.p[1][col][M.n] = c1;
+        M.n += (c0 | c1) != 0;
+    }
+    else
+    {
+        // the other column may be shorter than M.n limbs
+        size_type n = M.n;
+        while(n > 1 && (M.p[0][1-col][n-1] | M.p[1][1-col][n-1]) == 0)
+            --n;
+        size_type tn = n + qn, rn = std::max(tn, M.n);
+        assert(rn < M.alloc);
+        limb_type c[2];
+        for(unsigned row = 0; row < 2; ++row)
+        {
+            limb_type *rp = M.p[row][col];
+            if(qn <= n) mul(tp, M.p[row][1-col], n, qp, qn);
+            else mul(tp, qp, qn, M.p[row][1-col], n);
+            if(tn >= M.n) c[row] = add(rp, tp, tn, rp, M.n);
+            else c[row] = add(rp, rp, M.n, tp, tn);
+        }
+        if(c[0] | c[1])
+        {
+            M.p[0][col][rn] = c[0], M.p[1][col][rn] = c[1];
+            ++rn;
+        }
+        else
+        {
+            while(rn > M.n && (M.p[0][col][rn-1] | M.p[1][col][rn-1]) == 0)
+                --rn;
+        }
+        M.n = rn;
+    }
+    assert(M.n < M.alloc);
+}
+
+// M = M * M1
+static void matrix_mul(hgcd_matrix &M, const hgcd_matrix &M1)
+{
+    // the new entries have about M.n + M1.n limbs, and never fewer than
+    // that minus 3
+    size_type n = M.n, m = M1.n, rn = n + m;
+    assert(rn < M.alloc);
+    std::vector<limb_type> buf(3 * rn);
+    limb_type *t0 = buf.data(), *t1 = t0 + rn, *t2 = t1 + rn;
+    for(int row = 0; row < 2; ++row)
+    {
+        limb_type *x = M.p[row][0], *y = M.p[row][1];
+        for(int col = 0; col < 2; ++col)
+        {
+            limb_type *rp = col ? t1 : t0;
+            if(n >= m)
+            {
+                mul(rp, x, n, M1.p[0][col], m);
+                mul(t2, y, n, M1.p[1][col], m);
+            }
+            else
+            {
+                mul(rp, M1.p[0][col], m, x, n);
+                mul(t2, M1.p[1][col], m, y, n);
+            }
+            limb_type *dst = col ? y : x;
+            dst[rn] = add_n(rp, rp, t2, rn);
+        }
+        std::copy(t0, t0 + rn, x);
+        std::copy(t1, t1 + rn, y);
+    }
+    // index of the last limb which may be nonzero
+    n = rn;
+    for(int i = 0; i < 3 && (M.p[0][0][n] | M.p[0][1][n] | M.p[1][0][n] | M.p[1][1][n]) == 0; ++i)
+        --n;
+    M.n = n + 1;
+}
+
+// (a; b) = M^-1 (a; b), where the high parts (ap + p, n - p) and
+// (bp + p, n - p) are already reduced by M, and the low p limbs are not,
+// ap and bp have room for n + 1 limbs, return the new size
+static size_type matrix_adjust(const hgcd_matrix &M, size_type n,
+                               limb_type *ap, limb_type *bp, size_type p)
+{
+    assert(p + M.n < n);
+    size_type mn = M.n, tn = p + mn;
+    std::vector<limb_type> buf(2 * tn);
+    limb_type *t0 = buf.data(), *t1 = t0 + tn;
+    auto mul_low = [&](limb_type *rp, const limb_type *mp, const limb_type *xp) {
+        if(mn >= p) mul(rp, mp, mn, xp, p);
+        else mul(rp, xp, p, mp, mn);
+    };
+
+    // both products with the low part of a, before a is overwritten
+    mul_low(t0, M.p[1][1], ap);
+    mul_low(t1, M.p[1][0], ap);
+    // a = m11 a - m01 b
+    std::copy(t0, t0 + p, ap);
+    limb_type ah = add(ap + p, ap + p, n - p, t0 + p, mn);
+    mul_low(t0, M.p[0][1], bp);
+    limb_type cy = sub(ap, ap, n, t0, tn);
+    assert(cy <= ah);
+    ah -= cy;
+    // b = m00 b - m10 a
+    mul_low(t0, M.p[0][0], bp);
+    std::copy(t0, t0 + p, bp);
+    limb_type bh = add(bp + p, bp + p, n - p, t0 + p, mn);
+    cy = sub(bp, bp, n, t1, tn);
+    assert(cy <= bh);
+    bh -= cy;
+
+    if(ah | bh)
+    {
+        ap[n] = ah, bp[n] = bh;
+        ++n;
+    }
+    else if((ap[n-1] | bp[n-1]) == 0)
+        --n; // the subtraction reduces the size by at most one limb
+    return n;
+}
+
+// One subtraction and one division when hgcd2 can not help, but neither
+// a, b nor |a - b| may become s limbs or shorter, return the new size, or
+// 0 if no reduction is possible. tp has 3n limbs.
+static size_type subdiv_step(limb_type *ap, limb_type *bp, size_type n, size_type s,
+                             hgcd_matrix &M, limb_type *tp)
+{
+    static const limb_type one = 1;
+    size_type an = normalize(ap, n), bn = normalize(bp, n);
+    unsigned swapped = 0;
+
+    // arrange a < b, and subtract b -= a
+    if(an == bn)
+    {
+        int c = cmp(ap, bp, an);
+        if(c == 0) return 0;
+        if(c > 0) std::swap(ap, bp), swapped ^= 1;
+    }
+    else if(an > bn)
+        std::swap(ap, bp), std::swap(an, bn), swapped ^= 1;
+    if(an <= s) return 0;
+
+    sub(bp, bp, bn, ap, an);
+    bn = normalize(bp, bn);
+    if(bn <= s)
+    {
+        // undo the subtraction
+        limb_type cy = add(bp, ap, an, bp, bn);
+        if(cy) bp[an] = cy;
+        return 0;
+    }
+
+    // arrange a < b again
+    if(an == bn)
+    {
+        int c = cmp(ap, bp, an);
+        matrix_update_q(M, &one, 1, swapped, tp);
+        if(c == 0) return an;
+        if(c > 0) std::swap(ap, bp), swapped ^= 1;
+    }
+    else
+    {
+        matrix_update_q(M, &one, 1, swapped, tp);
+        if(an > bn)
+            std::swap(ap, bp), std::swap(an, bn), swapped ^= 1;
+    }
+
+    // b = q * a + r
+    limb_type *qp = tp;
+    size_type qn = bn - an + 1;
+    divrem(qp, bp, bp, bn, ap, an);
+    size_type rn = an;
+    bn = normalize(bp, an);
+    if(bn <= s)
+    {
+        // the quotient is one too large, decrease it and add a back
+        limb_type cy = add(bp, ap, an, bp, bn);
+        if(cy) bp[rn++] = cy;
+        sub_1(qp, qp, qn, 1);
+    }
+    qn = normalize(qp, qn);
+    if(qn > 0)
+        matrix_update_q(M, qp, qn, swapped, tp + qn);
+    return rn;
+}
+
+// one step of hgcd, by hgcd2 if possible, return the new size or 0,
+// tp has 3n limbs
+static size_type hgcd_step(size_type n, limb_type *ap, limb_type *bp, size_type s,
+                           hgcd_matrix &M, limb_type *tp)
+{
+    assert(n > s);
+    limb_type mask = ap[n-1] | bp[n-1];
+    assert(mask > 0);
+    dlimb_type a, b;
+    if(n == s + 1)
+    {
+        if(mask < 4)
+            return subdiv_step(ap, bp, n, s, M, tp);
+        a = (dlimb_type(ap[n-1]) << LIMB_BITS) | ap[n-2];
+        b = (dlimb_type(bp[n-1]) << LIMB_BITS) | bp[n-2];
+    }
+    else
+    {
+        // the leading two limbs of the larger one are normalized
+        unsigned shift = 0;
+        for(limb_type top = mask; !(top >> (LIMB_BITS - 1)); top <<= 1) ++shift;
+        unsigned rs = 2 * LIMB_BITS - shift;
+        a = (dlimb_type(ap[n-1]) << LIMB_BITS) | ap[n-2];
+        b = (dlimb_type(bp[n-1]) << LIMB_BITS) | bp[n-2];
+        if(shift)
+        {
+            a = (a << shift) | (ap[n-3] >> (rs - LIMB_BITS));
+            b = (b << shift) | (bp[n-3] >> (rs - LIMB_BITS));
+        }
+    }
+
+    hgcd_matrix1 M1;
+    if(hgcd2(a, b, M1))
+    {
+        matrix_mul_1(M, M1, tp);
+        std::copy(ap, ap + n, tp);
+        return matrix1_inverse_mul_vector(M1, ap, tp, bp, n);
+    }
+    return subdiv_step(ap, bp, n, s, M, tp);
+}
+
+// Reduce (ap, n) and (bp, n) until |a - b| has at most n/2 + 1 limbs, M is
+// the identity of hgcd_matrix(n) at first and becomes the reduction, the
+// entries have at most (n + 1) / 2 - 1 limbs. Return the new size, or 0 if
+// no reduction is possible. ap and bp have room for n + 1 limbs, and tp has
+// 3n limbs.
+static size_type hgcd(limb_type *ap, limb_type *bp, size_type n, hgcd_matrix &M,
+                      limb_type *tp)
+{
+    size_type s = n / 2 + 1;
+    if(n <= s) return 0;
+    assert((ap[n-1] | bp[n-1]) > 0);
+
+    bool success = false;
+    size_type nn;
+    if(n >= HGCD_THRESHOLD)
+    {
+        // reduce the high half recursively, and then apply the matrix to
+        // the whole numbers
+        size_type n2 = 3 * n / 4 + 1, p = n / 2;
+        nn = hgcd(ap + p, bp + p, n - p, M, tp);
+        if(nn)
+        {
+            n = matrix_adjust(M, p + nn, ap, bp, p);
+            success = true;
+        }
+        while(n > n2)
+        {
+            nn = hgcd_step(n, ap, bp, s, M, tp);
+            if(!nn) return success ? n : 0;
+            n = nn;
+            success = true;
+        }
+        // and then the high part of the rest, which is about 3/4 of it
+        if(n > s + 2)
+        {
+            p = 2 * s - n + 1;
+            hgcd_matrix M1(n - p);
+            nn = hgcd(ap + p, bp + p, n - p, M1, tp);
+            if(nn)
+            {
+                n = matrix_adjust(M1, p + nn, ap, bp, p);
+                matrix_mul(M, M1);
+                success = true;
+            }
+        }
+    }
+
+    while(true)
+    {
+        nn = hgcd_step(n, ap, bp, s, M, tp);
+        if(!nn) return success ? n : 0;
+        n = nn;
+        success = true;
+    }
+}
+
+// (u0; u1) = (m11 u0 + m01 u1; m10 u0 + m00 u1), the cofactors after the
+// reduction (x; y) = M^-1 (x; y)
+static void cofactors_mul_matrix(cofactors &c, const hgcd_matrix &M)
+{
+    size_type n = c.n, mn = M.n, tn = n + mn;
+    auto mul_entry = [&](limb_type *rp, const limb_type *mp, const limb_type *up) {
+        if(mn >= n) mul(rp, mp, mn, up, n);
+        else mul(rp, up, n, mp, mn);
+    };
+    mul_entry(c.w0, M.p[1][1], c.u0);
+    mul_entry(c.w1, M.p[0][1], c.u1);
+    c.w0[tn] = add_n(c.w0, c.w0, c.w1, tn);
+    mul_entry(c.w1, M.p[1][0], c.u0);
+    // the products may have a few zero limbs more than the cofactors
+    size_type n0 = normalize(c.w0, tn + 1);
+    std::copy(c.w0, c.w0 + n0, c.u0);
+    if(n0 < n) std::fill(c.u0 + n0, c.u0 + n, limb_type(0));
+    mul_entry(c.w0, M.p[0][0], c.u1);
+    c.w1[tn] = add_n(c.w1, c.w1, c.w0, tn);
+    size_type n1 = normalize(c.w1, tn + 1);
+    std::copy(c.w1, c.w1 + n1, c.u1);
+    if(n1 < n) std::fill(c.u1 + n1, c.u1 + n, limb_type(0));
+    c.n = std::max(std::max(n0, n1), size_type(1));
+}
+
+// the gcd of a >= b, with the cofactors if c is not nullptr
+static size_type gcd_cofactors(limb_type *rp, limb_type *ap, size_type an,
+                               limb_type *bp, size_type bn, cofactors *c)
+{
+    if(bn < GCD_DC_THRESHOLD)
+        return gcd_lehmer(rp, ap, an, bp, bn, c);
+
+    // a = a mod b first, then both of them have n limbs, and hgcd on the
+    // high third reduces them by about n/6 limbs at a time, until they are
+    // small enough for Lehmer's algorithm
+    size_type n = bn;
+    std::vector<limb_type> buf(2 * (n + 1) + 3 * n + (c ? an - bn + 1 : 0));
+    limb_type *u = buf.data(), *v = u + n + 1, *tp = v + n + 1, *qp = tp + 3 * n;
+    if(an > bn)
+    {
+        divrem(c ? qp : nullptr, u, ap, an, bp, bn);
+        if(c) c->add_q(qp, an - bn + 1);
+    }
+    else std::copy(ap, ap + n, u);
+    std::copy(bp, bp + n, v);
+    while(n >= GCD_DC_THRESHOLD)
+    {
+        size_type p = 2 * n / 3;
+        hgcd_matrix M(n - p);
+        size_type nn = hgcd(u + p, v + p, n - p, M, tp);
+        if(nn)
+        {
+            n = matrix_adjust(M, p + nn, u, v, p);
+            if(c) cofactors_mul_matrix(*c, M);
+            continue;
+        }
+        // hgcd failed, so one of them is much smaller, take a division step
+        size_type un = normalize(u, n), vn = normalize(v, n);
+        if(un < vn || (un == vn && cmp(u, v, un) < 0))
+        {
+            std::swap(u, v), std::swap(un, vn);
+            if(c) c->swap();
+        }
+        if(vn == 0) break;
+        divrem(c ? tp : nullptr, u, u, un, v, vn);
+        if(c) c->add_q(tp, un - vn + 1);
+        std::fill(u + vn, u + n, limb_type(0));
+        n = vn;
+    }
+    return gcd_lehmer(rp, u, normalize(u, n), v, normalize(v, n), c);
+}
+
+size_type gcd(limb_type *rp, limb_type *ap, size_type an, limb_type *bp, size_type bn)
+{
+    an = normalize(ap, an);
+    bn = normalize(bp, bn);
+    if(an < bn || (an == bn && an > 0 && cmp(ap, bp, an) < 0))
+        std::swap(ap, bp), std::swap(an, bn);
+    return gcd_cofactors(rp, ap, an, bp, bn, nullptr);
+}
+
+size_type gcdext(limb_type *gp, limb_type *sp, std::ptrdiff_t &sn,
+                 limb_type *ap, size_type an, limb_type *bp, size_type bn)
+{
+    an = normalize(ap, an);
+    bn = normalize(bp, bn);
+    assert(bn > 0);
+    cofactors c(bn);
+    if(an < bn || (an == bn && cmp(ap, bp, an) < 0))
+    {
+        std::swap(ap, bp), std::swap(an, bn);
+        c.swap();
+    }
+    size_type gn = gcd_cofactors(gp, ap, an, bp, bn, &c);
+    size_type un = normalize(c.u0, c.n);
+    std::copy(c.u0, c.u0 + un, sp);
+    sn = c.sign > 0 ? std::ptrdiff_t(un) : -std::ptrdiff_t(un);
+    return gn;
+}
+
+} // namespace mpn
+
+} // namespace kedixa
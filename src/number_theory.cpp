@@ -0,0 +1,618 @@
+#include "kedixa/number_theory.h"
+#include "kedixa/modular.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace kedixa {
+
+namespace {
+
+using ubigint = unsigned_bigint;
+
+ubigint power(const ubigint &x, unsigned k)
+{
+    ubigint r(1u), b(x);
+    for(; k; k >>= 1)
+    {
+        if(k & 1) r *= b;
+        if(k > 1) b *= b;
+    }
+    return r;
+}
+
+// floor(n^(1/k)) for k >= 2, n > 0, the root is estimated by floating point
+// arithmetic from the top limbs when it is short, or by Newton's iteration
+// from the root of the top half of n, which doubles the precision
+ubigint root(const ubigint &n, unsigned k)
+{
+    unsigned_bigint::size_type bits = n.bit_length();
+    if(bits / k < 32)
+    {
+        // log2(n) from the leading 64 bits, the estimate is off by at most
+        // one or two when the root has less than 32 bits
+        unsigned_bigint::size_type shift = bits > 64 ? bits - 64 : 0;
+        ubigint high = n >> shift;
+        mpn::const_view v = high.view();
+        double top = v[0] + (v.size() > 1 ? std::ldexp(double(v[1]), 32) : 0.0);
+        double est = std::exp2((std::log2(top) + double(shift)) / k);
+        ubigint r(mpn::limb_type(std::min(est, 4294967295.0)));
+        while(r > 0u && power(r, k) > n) r -= 1u;
+        while(power(r + 1u, k) <= n) r += 1u;
+        return r;
+    }
+
+    // x = (root(n / 2^(ks)) + 1) * 2^s is greater than the root, and has half
+    // of its bits right, then Newton's iteration decreases it to the root
+    unsigned_bigint::size_type s = bits / (2 * k);
+    ubigint x = root(n >> (k * s), k);
+    x += 1u;
+    x <<= s;
+    while(true)
+    {
+        ubigint y = (x * (k - 1) + n / power(x, k - 1)) / k;
+        if(y >= x) return x;
+        x.swap(y);
+    }
+}
+
+// the quadratic residues modulo 256, 63, 65, 11, 17 and 19, where
+// 63 * 65 * 11 * 17 * 19 fits in a limb
+struct square_filter {
+    static const mpn::limb_type MOD = 63u * 65u * 11u * 17u * 19u;
+    bool r256[256], r63[63], r65[65], r11[11], r17[17], r19[19];
+
+    square_filter()
+    {
+        std::fill(r256, r256 + 256, false);
+        std::fill(r63, r63 + 63, false), std::fill(r65, r65 + 65, false);
+        std::fill(r11, r11 + 11, false), std::fill(r17, r17 + 17, false);
+        std::fill(r19, r19 + 19, false);
+        for(unsigned i = 0; i < 256; ++i)
+        {
+            r256[i * i % 256] = true;
+            r63[i * i % 63] = r65[i * i % 65] = true;
+            r11[i * i % 11] = r17[i * i % 17] = r19[i * i % 19] = true;
+        }
+    }
+    // false if n is not a square
+    bool pass(const ubigint &n) const
+    {
+        mpn::const_view v = n.view();
+        if(!r256[v[0] & 255u]) return false;
+        mpn::limb_type r = mpn::mod_1(v.data(), v.size(), MOD);
+        return r63[r % 63] && r65[r % 65] && r11[r % 11] && r17[r % 17] && r19[r % 19];
+    }
+};
+
+// false if n is not a p-th power, p is an odd prime, by the p-th power
+// residues modulo a few primes q = 2mp + 1, each of them lets about 1/p of
+// the numbers pass
+bool power_filter(const ubigint &n, unsigned p)
+{
+    auto is_prime = [](uint64_t q) {
+        for(uint64_t d = 3; d * d <= q; d += 2)
+            if(q % d == 0) return false;
+        return true;
+    };
+    mpn::const_view v = n.view();
+    int tested = 0;
+    for(uint64_t q = 2 * uint64_t(p) + 1; tested < 3 && q < (uint64_t(1) << 31); q += 2 * p)
+    {
+        if(!is_prime(q)) continue;
+        ++tested;
+        uint64_t r = mpn::mod_1(v.data(), v.size(), mpn::limb_type(q));
+        if(r == 0) continue;
+        // r^((q - 1) / p) mod q is 1 for the p-th powers
+        uint64_t x = 1;
+        for(uint64_t e = (q - 1) / p; e; e >>= 1)
+        {
+            if(e & 1) x = x * r % q;
+            r = r * r % q;
+        }
+        if(x != 1) return false;
+    }
+    return true;
+}
+
+
+// the odd primes below 2^16, grouped so that the product of each group fits
+// in a limb, then the residues of a number modulo all of them are taken in
+// one pass over its limbs. The trial division of a single number stops at
+// 2^11, and the sieve of next_prime uses all of them.
+struct small_primes {
+    static const mpn::limb_type LIMIT = 1u << 16;
+    static const mpn::limb_type TRIAL_LIMIT = 1u << 11;
+    std::vector<mpn::limb_type> primes;
+    std::vector<mpn::limb_type> products;
+    std::vector<std::size_t> first;     // the first prime of each group
+
+    small_primes()
+    {
+        std::vector<bool> composite(LIMIT, false);
+        for(mpn::limb_type p = 3; p < LIMIT; p += 2)
+        {
+            if(composite[p]) continue;
+            primes.push_back(p);
+            for(mpn::dlimb_type q = mpn::dlimb_type(p) * p; q < LIMIT; q += 2 * p)
+                composite[q] = true;
+        }
+        mpn::dlimb_type prod = 1;
+        for(std::size_t i = 0; i < primes.size(); ++i)
+        {
+            if(prod * primes[i] >> mpn::LIMB_BITS)
+            {
+                products.push_back(mpn::limb_type(prod));
+                prod = 1;
+            }
+            if(prod == 1) first.push_back(i);
+            prod *= primes[i];
+        }
+        products.push_back(mpn::limb_type(prod));
+        first.push_back(primes.size());
+    }
+
+    // rs[i] = n mod primes[i] for the primes below limit, or a few more
+    void residues(const ubigint &n, std::vector<mpn::limb_type> &rs,
+                  mpn::limb_type limit = LIMIT) const
+    {
+        std::size_t groups = 0;
+        while(groups < products.size() && primes[first[groups]] < limit)
+            ++groups;
+        mpn::const_view v = n.view();
+        std::vector<mpn::dlimb_type> rg(groups, 0);
+        for(std::size_t i = v.size(); i-- > 0; )
+            for(std::size_t g = 0; g < groups; ++g)
+                rg[g] = ((rg[g] << mpn::LIMB_BITS) | v[i]) % products[g];
+        rs.resize(first[groups]);
+        for(std::size_t g = 0; g < groups; ++g)
+            for(std::size_t i = first[g]; i < first[g+1]; ++i)
+                rs[i] = mpn::limb_type(rg[g] % primes[i]);
+    }
+
+    static const small_primes& get()
+    {
+        static const small_primes table;
+        return table;
+    }
+};
+
+// the Jacobi symbol (a/n) of small numbers, n is odd
+int jacobi(uint64_t a, uint64_t n) noexcept
+{
+    int j = 1;
+    a %= n;
+    while(a)
+    {
+        for(; a % 2 == 0; a /= 2)
+            if(n % 8 == 3 || n % 8 == 5) j = -j;
+        std::swap(a, n);
+        if(a % 4 == 3 && n % 4 == 3) j = -j;
+        a %= n;
+    }
+    return n == 1 ? j : 0;
+}
+
+// arithmetic modulo n on the numbers less than n, the values of the Lucas
+// sequences are kept in Montgomery form, which is kept by these operations
+void add_mod(ubigint &a, const ubigint &b, const ubigint &n)
+{
+    a += b;
+    if(a >= n) a -= n;
+}
+void sub_mod(ubigint &a, const ubigint &b, const ubigint &n)
+{
+    if(a < b) a += n;
+    a -= b;
+}
+void half_mod(ubigint &a, const ubigint &n)
+{
+    if(a.view()[0] & 1) a += n;
+    a >>= 1;
+}
+// c mod n in Montgomery form
+ubigint to_mont_small(const montgomery_context &ctx, long long c)
+{
+    const ubigint &n = ctx.modulus();
+    ubigint a(mpn::limb_type(c < 0 ? -c : c));
+    a %= n;
+    if(c < 0 && a != 0u) a = n - a;
+    return ctx.to_mont(a);
+}
+
+// the strong probable prime test to base a, n is odd, n - 1 = d * 2^s
+bool strong_probable_prime(const montgomery_context &ctx, const ubigint &a,
+                           const ubigint &d, unsigned_bigint::size_type s)
+{
+    const ubigint &n = ctx.modulus();
+    ubigint x = a.powmod(d, n), minus_one = n - 1u;
+    if(x == 1u || x == minus_one) return true;
+    x = ctx.to_mont(x);
+    minus_one = ctx.to_mont(minus_one);
+    for(unsigned_bigint::size_type i = 1; i < s; ++i)
+    {
+        ctx.sqr_eq(x);
+        if(x == minus_one) return true;
+    }
+    return false;
+}
+
+// the strong Lucas probable prime test with the parameters of Selfridge,
+// D is the first of 5, -7, 9, -11, ... with (D/n) = -1, P = 1 and
+// Q = (1 - D) / 4, n is odd, not a square and has no small factors
+bool strong_lucas_probable_prime(const montgomery_context &ctx)
+{
+    const ubigint &n = ctx.modulus();
+    mpn::const_view v = n.view();
+    long long D = 5;
+    while(true)
+    {
+        // (D/n) = (n/|D|) by the reciprocity, as |D| = 1 mod 4 or the sign
+        // of D makes up for it
+        uint64_t ad = D < 0 ? -D : D;
+        int j = jacobi(mpn::mod_1(v.data(), v.size(), mpn::limb_type(ad)), ad);
+        if(D < 0 && ad % 4 == 1 && v[0] % 4 == 3) j = -j;
+        if(D > 0 && ad % 4 == 3 && v[0] % 4 == 3) j = -j;
+        if(j == -1) break;
+        if(j == 0) return false;
+        D = D > 0 ? -(D + 2) : -D + 2;
+    }
+    long long Q = (1 - D) / 4;
+
+    // n + 1 = d * 2^s
+    ubigint d = n + 1u;
+    unsigned_bigint::size_type s = d.count_trailing_zeros();
+    d >>= s;
+    unsigned_bigint::size_type bits = d.bit_length();
+
+    // (U_k, V_k, Q^k) from k = 1, by U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k,
+    // U_k+1 = (P U_k + V_k) / 2 and V_k+1 = (D U_k + P V_k) / 2
+    // D and Q are converted once, so each step is a Montgomery product
+    const ubigint Dm = to_mont_small(ctx, D), Qm = to_mont_small(ctx, Q);
+    ubigint one = ctx.to_mont(ubigint(1u));
+    ubigint U = one, V = one, Qk = Qm, t;
+    for(unsigned_bigint::size_type i = bits - 1; i-- > 0; )
+    {
+        ctx.mul_eq(U, V);
+        ctx.sqr_eq(V);
+        t = Qk;
+        add_mod(t, Qk, n);
+        sub_mod(V, t, n);
+        ctx.sqr_eq(Qk);
+        if(d.test_bit(i))
+        {
+            t = U;
+            ctx.mul_eq(t, Dm);
+            add_mod(U, V, n);
+            half_mod(U, n);
+            add_mod(V, t, n);
+            half_mod(V, n);
+            ctx.mul_eq(Qk, Qm);
+        }
+    }
+    if(U == 0u || V == 0u) return true;
+    for(unsigned_bigint::size_type r = 1; r < s; ++r)
+    {
+        ctx.sqr_eq(V);
+        t = Qk;
+        add_mod(t, Qk, n);
+        sub_mod(V, t, n);
+        if(V == 0u) return true;
+        ctx.sqr_eq(Qk);
+    }
+    return false;
+}
+
+// BPSW and rounds of Miller-Rabin with pseudo random bases, n is odd and
+// has no factors below TRIAL_LIMIT
+bool probable_prime_no_small_factors(const ubigint &n, unsigned rounds)
+{
+    montgomery_context ctx(n);
+    ubigint d = n - 1u;
+    unsigned_bigint::size_type s = d.count_trailing_zeros();
+    d >>= s;
+    if(!strong_probable_prime(ctx, ubigint(2u), d, s)) return false;
+    if(is_square(n) || !strong_lucas_probable_prime(ctx)) return false;
+
+    // the bases are in [2, n - 2], and the same for the same n
+    std::mt19937 gen(n.view()[0]);
+    ubigint range = n - 3u;
+    for(unsigned r = 0; r < rounds; ++r)
+    {
+        ubigint a = random_below(range, gen);
+        a += 2u;
+        if(!strong_probable_prime(ctx, a, d, s)) return false;
+    }
+    return true;
+}
+
+// the levels of a product tree are shared by threads only when the factors
+// have this many limbs, smaller multiplications do not pay for a thread
+const mpn::size_type PRODUCT_THREAD_THRESHOLD = 64;
+
+// next[i] = v[2i] * v[2i+1] for i in [lo, hi)
+void multiply_pairs(const std::vector<ubigint> &v, std::vector<ubigint> &next,
+                    std::size_t lo, std::size_t hi)
+{
+    for(std::size_t i = lo; i < hi; ++i)
+        next[i] = v[2 * i] * v[2 * i + 1];
+}
+
+// the small factors of a product, packed into 64-bit leaves
+struct factor_list {
+    std::vector<ubigint> leaves;
+    uint64_t acc = 1;
+
+    void push(uint64_t x)
+    {
+        if(acc > UINT64_MAX / x) flush();
+        acc *= x;
+    }
+    void flush()
+    {
+        mpn::limb_type l[2] = {mpn::limb_type(acc), mpn::limb_type(acc >> 32)};
+        leaves.emplace_back(mpn::const_view(l, 2));
+        acc = 1;
+    }
+    ubigint product(unsigned threads)
+    {
+        if(acc > 1) flush();
+        return kedixa::product(std::move(leaves), threads);
+    }
+};
+
+// the primes not greater than n
+std::vector<unsigned> primes_up_to(unsigned n)
+{
+    std::vector<unsigned> primes;
+    if(n < 2) return primes;
+    primes.push_back(2);
+    // composite[i] for 2i + 1
+    std::vector<bool> composite(n / 2 + 1, false);
+    for(uint64_t p = 3; p <= n; p += 2)
+    {
+        if(composite[p / 2]) continue;
+        primes.push_back(unsigned(p));
+        for(uint64_t q = p * p; q <= n; q += 2 * p)
+            composite[q / 2] = true;
+    }
+    return primes;
+}
+
+// the odd part of n!, by n! = (floor(n/2)!)^2 * swing(n), where the swinging
+// factorial swing(n) is the product of p^e over the primes p <= n, and e is
+// the number of odd floor(n / p^i), i >= 1
+ubigint odd_factorial(unsigned n, const std::vector<unsigned> &primes, unsigned threads)
+{
+    if(n < 3) return ubigint(1u);
+    ubigint r = odd_factorial(n / 2, primes, threads);
+    r *= r;
+    factor_list swing;
+    for(std::size_t i = 1; i < primes.size() && primes[i] <= n; ++i)
+    {
+        unsigned p = primes[i];
+        for(unsigned q = n / p; q; q /= p)
+            if(q & 1) swing.push(p);
+    }
+    r *= swing.product(threads);
+    return r;
+}
+
+} // namespace
+
+unsigned_bigint product(std::vector<unsigned_bigint> factors, unsigned threads)
+{
+    if(factors.empty()) return unsigned_bigint(1u);
+    std::vector<unsigned_bigint> &v = factors;
+    std::vector<unsigned_bigint> next;
+    while(v.size() > 1)
+    {
+        std::size_t m = v.size() / 2;
+        next.resize(m + v.size() % 2);
+        std::size_t t = std::min<std::size_t>(threads, m);
+        if(t <= 1 || v[0].view().size() < PRODUCT_THREAD_THRESHOLD)
+            multiply_pairs(v, next, 0, m);
+        else
+        {
+            // thread j takes the pairs [m * j / t, m * (j + 1) / t), and the
+            // errors are thrown after all of them are joined
+            std::vector<std::thread> workers;
+            std::vector<std::exception_ptr> errors(t);
+            try {
+                for(std::size_t j = 1; j < t; ++j)
+                    workers.emplace_back([&, j] {
+                        try { multiply_pairs(v, next, m * j / t, m * (j + 1) / t); }
+                        catch(...) { errors[j] = std::current_exception(); }
+                    });
+                multiply_pairs(v, next, 0, m / t);
+            }
+            catch(...) { errors[0] = std::current_exception(); }
+            for(auto &w : workers) w.join();
+            for(auto &e : errors)
+                if(e) std::rethrow_exception(e);
+        }
+        if(v.size() % 2) next[m].swap(v.back());
+        v.swap(next);
+    }
+    return std::move(v[0]);
+}
+
+unsigned_bigint factorial(unsigned n, unsigned threads)
+{
+    // the power of 2 in n! is n - popcount(n)
+    unsigned ones = 0;
+    for(unsigned x = n; x; x &= x - 1) ++ones;
+    return odd_factorial(n, primes_up_to(n), threads) << (n - ones);
+}
+
+unsigned_bigint binomial(unsigned n, unsigned k, unsigned threads)
+{
+    if(k > n) return unsigned_bigint(0u);
+    k = std::min(k, n - k);
+    // C(n, k) = (n - k + 1) ... n / k!, each prime p <= k is divided out of
+    // the terms of the numerator, which are the multiples of p^i in the
+    // window, and then p^e is put back, e is the exponent of p in C(n, k)
+    uint64_t lo = uint64_t(n) - k + 1;
+    std::vector<uint64_t> terms(k);
+    for(unsigned i = 0; i < k; ++i)
+        terms[i] = lo + i;
+    factor_list f;
+    for(unsigned p : primes_up_to(k))
+    {
+        unsigned e = 0;
+        for(uint64_t pp = p; pp <= n; pp *= p)
+        {
+            for(uint64_t x = (lo + pp - 1) / pp * pp; x <= n; x += pp)
+                terms[x - lo] /= p, ++e;
+            e -= unsigned(k / pp);
+        }
+        while(e--) f.push(p);
+    }
+    for(uint64_t x : terms)
+        if(x > 1) f.push(x);
+    return f.product(threads);
+}
+
+unsigned_bigint gcd(const unsigned_bigint &a, const unsigned_bigint &b)
+{
+    if(a == 0u) return b;
+    if(b == 0u) return a;
+    // mpn::gcd works in place, on copies of both operands in one buffer
+    mpn::const_view av = a.view(), bv = b.view();
+    mpn::size_type an = av.size(), bn = bv.size();
+    std::vector<mpn::limb_type> buf(an + bn + std::max(an, bn));
+    mpn::limb_type *ap = buf.data(), *bp = ap + an, *rp = bp + bn;
+    std::copy(av.begin(), av.end(), ap);
+    std::copy(bv.begin(), bv.end(), bp);
+    mpn::size_type rn = mpn::gcd(rp, ap, an, bp, bn);
+    return unsigned_bigint(mpn::const_view(rp, rn));
+}
+
+std::tuple<bigint, bigint, bigint> gcdext(const bigint &a, const bigint &b)
+{
+    // on |a| and |b|, then the cofactors take the signs of a and b
+    unsigned_bigint ua = a.to_ubigint(), ub = b.to_ubigint();
+    if(ub == 0u)
+        return std::make_tuple(bigint(ua), bigint(a < 0 ? -1 : (a == 0 ? 0 : 1)), bigint(0));
+    mpn::const_view av = ua.view(), bv = ub.view();
+    mpn::size_type an = av.size(), bn = bv.size();
+    std::vector<mpn::limb_type> buf(an + 2 * bn + std::max(an, bn));
+    mpn::limb_type *ap = buf.data(), *bp = ap + an, *sp = bp + bn, *gp = sp + bn;
+    std::copy(av.begin(), av.end(), ap);
+    std::copy(bv.begin(), bv.end(), bp);
+    std::ptrdiff_t sn;
+    mpn::size_type gn = mpn::gcdext(gp, sp, sn, ap, an, bp, bn);
+    bigint g(unsigned_bigint(mpn::const_view(gp, gn)));
+    bigint s(unsigned_bigint(mpn::const_view(sp, sn < 0 ? -sn : sn)), sn < 0);
+    // the division is exact
+    bigint t = (g - s * bigint(ua)) / bigint(ub);
+    if(a < 0) s.opposite();
+    if(b < 0) t.opposite();
+    return std::make_tuple(std::move(g), std::move(s), std::move(t));
+}
+
+unsigned_bigint isqrt(const unsigned_bigint &n)
+{ return iroot(n, 2); }
+
+unsigned_bigint iroot(const unsigned_bigint &n, unsigned k)
+{
+    if(k == 0)
+        throw std::runtime_error("iroot: k must be positive.");
+    if(k == 1 || n == 0u) return n;
+    return root(n, k);
+}
+
+bool is_square(const unsigned_bigint &n)
+{
+    static const square_filter filter;
+    if(!filter.pass(n)) return false;
+    unsigned_bigint r = isqrt(n);
+    return r * r == n;
+}
+
+bool is_perfect_power(const unsigned_bigint &n)
+{
+    if(n <= 1u) return true;
+    if(is_square(n)) return true;
+
+    // n = x^k implies n = y^p for a prime p dividing k, and p divides the
+    // number of trailing zero bits of n
+    unsigned_bigint::size_type zeros = n.count_trailing_zeros();
+    if(zeros == 1) return false;
+
+    unsigned_bigint::size_type bits = n.bit_length();
+    std::vector<bool> composite(bits + 1, false);
+    for(unsigned_bigint::size_type p = 3; p <= bits; p += 2)
+    {
+        if(composite[p]) continue;
+        for(unsigned_bigint::size_type q = p * p; q <= bits; q += 2 * p)
+            composite[q] = true;
+        if(zeros > 0 && zeros % p != 0) continue;
+        unsigned k = unsigned(p);
+        if(power_filter(n, k) && power(root(n, k), k) == n) return true;
+    }
+    return false;
+}
+
+bool is_probable_prime(const unsigned_bigint &n, unsigned rounds)
+{
+    const small_primes &table = small_primes::get();
+    if(n < small_primes::LIMIT)
+    {
+        mpn::limb_type x = mpn::limb_type(n);
+        return x == 2 || std::binary_search(table.primes.begin(), table.primes.end(), x);
+    }
+    if((n.view()[0] & 1) == 0) return false;
+    std::vector<mpn::limb_type> rs;
+    table.residues(n, rs, small_primes::TRIAL_LIMIT);
+    if(std::find(rs.begin(), rs.end(), mpn::limb_type(0)) != rs.end())
+        return false;
+    return probable_prime_no_small_factors(n, rounds);
+}
+
+unsigned_bigint next_prime(const unsigned_bigint &n, unsigned rounds)
+{
+    const small_primes &table = small_primes::get();
+    if(n < table.primes.back())
+    {
+        mpn::limb_type x = mpn::limb_type(n);
+        if(x < 2) return unsigned_bigint(2u);
+        return unsigned_bigint(*std::upper_bound(table.primes.begin(), table.primes.end(), x));
+    }
+
+    // sieve the odd candidates start + 2i for i < WINDOW by the small
+    // primes, the candidates are greater than them, and only the ones left
+    // are tested
+    const std::size_t WINDOW = 4096;
+    unsigned_bigint start = n + 1u;
+    if((start.view()[0] & 1) == 0) start += 1u;
+    std::vector<mpn::limb_type> rs;
+    std::vector<bool> composite(WINDOW);
+    while(true)
+    {
+        table.residues(start, rs);
+        std::fill(composite.begin(), composite.end(), false);
+        for(std::size_t j = 0; j < table.primes.size(); ++j)
+        {
+            // start + 2i = 0 mod p for i = (p - r) / 2 mod p
+            mpn::limb_type p = table.primes[j], r = rs[j];
+            mpn::limb_type i = r == 0 ? 0 : (r % 2 ? (p - r) / 2 : p - r / 2);
+            for(; i < WINDOW; i += p)
+                composite[i] = true;
+        }
+        for(std::size_t i = 0; i < WINDOW; ++i)
+        {
+            if(composite[i]) continue;
+            unsigned_bigint c = start + mpn::limb_type(2 * i);
+            if(probable_prime_no_small_factors(c, rounds))
+                return c;
+        }
+        start += mpn::limb_type(2 * WINDOW);
+    }
+}
+
+} // namespace kedixa
@@ -1,9 +1,37 @@
 #include "kedixa/rational.h"
+#include "kedixa/number_theory.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace kedixa {
 
+namespace {
+
+using limb_type = mpn::limb_type;
+
+// compare (ap, an) with (bp, bn) * m in one pass from the low limbs, without
+// storing the product, the last differing limb decides
+int cmp_mul_ull(const limb_type *ap, size_t an, const limb_type *bp, size_t bn, uint64_t m) noexcept
+{
+    const uint64_t lo = uint32_t(m), hi = m >> 32;
+    uint64_t carry = 0;
+    int cmp = 0;
+    for(size_t i = 0, n = std::max(an, bn + 2); i < n; ++i)
+    {
+        // b * lo + low half of carry fits in 64 bits, and so does the new
+        // carry b * hi + its high half + the high half of t
+        uint64_t b = i < bn ? bp[i] : 0;
+        uint64_t t = b * lo + uint32_t(carry);
+        carry = b * hi + (carry >> 32) + (t >> 32);
+        limb_type a = i < an ? ap[i] : 0, p = limb_type(t);
+        if(a != p) cmp = a < p ? -1 : 1;
+    }
+    return cmp;
+}
+
+} // namespace
+
 // constructors
 rational::rational(const ubigint &n, const ubigint &d, bool sign)
 {
@@ -62,7 +90,7 @@ rational& rational::operator/=(const rational &rat)
 
 // conversion operators
 rational::operator bool() const noexcept
-{ return this->num != 0u; }
+{ return !this->num.is_zero(); }
 
 // conversion functions
 long double rational::to_ld() const
@@ -127,120 +155,104 @@ int rational::compare(const rational &rat) const
     return cmp;
 }
 
+bool rational::is_zero() const noexcept
+{ return this->num.is_zero(); }
+bool rational::is_one() const noexcept
+{ return !this->sign && this->num.is_one() && this->den.is_one(); }
+int rational::sgn() const noexcept
+{ return this->sign ? -1 : this->num.sgn(); }
+
 rational rational::add (const rational &rat) const
 {
-    ubigint g = gcd(this->den, rat.den); // great common divisor
-    ubigint ag = this->den / g, cg = rat.den / g; // den / gcd
-
-    // using common method for fraction plus
-    // b/a + d/c = (bc+ad)/(ac) = (bc/g + da/g)/(ac/g)
-    rational result;
-    const ubigint &b = this->num, &d = rat.num;
-    result.den = ag * rat.den;
-    if(this->sign == rat.sign)
-    {
-        result.num = b * cg + d * ag;
-        result.sign = this->sign;
-    }
-    else
-    {
-        ubigint bcg = b * cg, dag = d * ag;
-        int cmp = bcg.compare(dag);
-        if(cmp >= 0)
-        {
-            result.num = std::move(bcg) - dag;
-            result.sign = this->sign;
-        }
-        else
-        {
-            result.num = std::move(dag) - bcg;
-            result.sign = !this->sign;
-        }
-    }
-    result.reduce();
+    rational result(*this);
+    result.add_eq_signed(rat, rat.sign);
     return result;
 }
 rational& rational::add_eq(const rational &rat)
-{ return *this = this->add(rat); }
+{ return this->add_eq_signed(rat, rat.sign); }
 rational  rational::sub (const rational &rat) const
 {
-    ubigint g = gcd(this->den, rat.den); // great common divisor
-    ubigint ag = this->den / g, cg = rat.den / g; // den / gcd
-
-    // using common method for fraction minus
-    // b/a - d/c = (bc-ad)/(ac) = (bc/g + da/g)/(ac/g)
-    rational result;
-    const ubigint &b = this->num, &d = rat.num;
-    result.den = ag * rat.den;
-    if(this->sign == rat.sign)
-    {
-        ubigint bcg = b * cg, dag = d * ag;
-        int cmp = bcg.compare(dag);
-        if(cmp >= 0)
-        {
-            result = std::move(bcg) - dag;
-            result.sign = this->sign;
-        }
-        else
-        {
-            result = std::move(dag) - bcg;
-            result.sign = !this->sign;
-        }
-    }
-    else
-    {
-        result.num = b * cg + d * ag;
-        result.sign = this->sign;
-    }
-    result.reduce();
+    rational result(*this);
+    result.add_eq_signed(rat, !rat.sign);
     return result;
 }
 rational& rational::sub_eq(const rational &rat)
-{ return *this = this->sub(rat); }
+{ return this->add_eq_signed(rat, !rat.sign); }
 rational  rational::multi(const rational &rat) const
 {
-    rational result;
+    rational result(*this);
+    result.multi_eq(rat);
+    return result;
+}
+rational& rational::multi_eq(const rational &rat)
+{
     // special case
-    if(this->num == ubigint(0u) || rat.num == ubigint(0u))
-        result = rational();
-    // common method for fraction multiply
-    else
+    if(this->num.is_zero())
+        return *this;
+    if(rat.num.is_zero())
     {
-        const ubigint &a = this->den, &b = this->num, &c = rat.den, &d = rat.num;
-        ubigint g1 = gcd(a, d), g2 = gcd(c, b);
-        result.num = (b/g2) * (d/g1);
-        result.den = (a/g1) * (c/g2);
-        result.sign= this->sign ^ rat.sign;
+        this->clear();
+        return *this;
     }
-    return result;
+    if(this == &rat)
+    {
+        // a reduced fraction is still reduced after squaring
+        this->num *= this->num;
+        this->den *= this->den;
+        this->sign = false;
+        return *this;
+    }
+    // common method for fraction multiply
+    // b/a * d/c = (b/g2 * d/g1) / (a/g1 * c/g2), g1 = gcd(a, d), g2 = gcd(c, b)
+    ubigint g1 = gcd(this->den, rat.num), g2 = gcd(rat.den, this->num);
+    if(!g2.is_one()) this->num /= g2;
+    if(!g1.is_one()) this->den /= g1;
+    if(g1.is_one()) this->num *= rat.num;
+    else this->num *= rat.num / g1;
+    if(g2.is_one()) this->den *= rat.den;
+    else this->den *= rat.den / g2;
+    this->sign ^= rat.sign;
+    return *this;
 }
-rational& rational::multi_eq(const rational &rat)
-{ return *this = this->multi(rat); }
 rational  rational::div(const rational &rat) const
 {
-    rational result;
-    if(this->num == ubigint(0u))
-        result = rational();
-    else if(rat.num == 0)
+    rational result(*this);
+    result.div_eq(rat);
+    return result;
+}
+rational& rational::div_eq(const rational &rat)
+{
+    if(this->num.is_zero())
+        return *this;
+    if(rat.num.is_zero())
         throw std::runtime_error("kedixa::rational: divide by zero.");
-    else
+    if(this == &rat)
     {
-        // b/a / d/c = b/a * c/d
-        const ubigint &a = this->den, &b = this->num, &c = rat.den, &d = rat.num;
-        ubigint g1 = gcd(a, c), g2 = gcd(d, b);
-        result.num = (b/g2) * (c/g1);
-        result.den = (a/g1) * (d/g2);
-        result.sign = this->sign ^ rat.sign;
+        this->num = ubigint(1u);
+        this->den = ubigint(1u);
+        this->sign = false;
+        return *this;
     }
-    return result;
+    // b/a / d/c = b/a * c/d
+    ubigint g1 = gcd(this->den, rat.den), g2 = gcd(rat.num, this->num);
+    if(!g2.is_one()) this->num /= g2;
+    if(!g1.is_one()) this->den /= g1;
+    if(g1.is_one()) this->num *= rat.den;
+    else this->num *= rat.den / g1;
+    if(g2.is_one()) this->den *= rat.num;
+    else this->den *= rat.num / g2;
+    this->sign ^= rat.sign;
+    return *this;
 }
-rational& rational::div_eq(const rational &rat)
-{ return *this = this->div(rat); }
 
 rational::ubigint rational::get_num() const
 { return this->num; }
 rational::ubigint rational::get_den() const
 { return this->den; }
+const rational::ubigint& rational::numerator() const noexcept
+{ return this->num; }
+const rational::ubigint& rational::denominator() const noexcept
+{ return this->den; }
 bool rational::get_sign() const
 { return this->sign; }
 void rational::approximate(rational::size_type hint)
@@ -256,7 +268,7 @@ void rational::approximate(rational::size_type hint)
 }
 void rational::opposite() noexcept
 { 
-    if(this->num != ubigint(0u))
+    if(!this->num.is_zero())
         this->sign = !this->sign;
     return;
 }
@@ -278,10 +290,31 @@ rational::size_type rational::num_size() const noexcept
 { return this->num.size(); }
 rational::size_type rational::den_size() const noexcept
 { return this->den.size(); }
+rational::size_type rational::num_capacity() const noexcept
+{ return this->num.capacity(); }
+rational::size_type rational::den_capacity() const noexcept
+{ return this->den.capacity(); }
+void rational::reserve(size_type num_limbs, size_type den_limbs)
+{
+    this->num.reserve(num_limbs);
+    this->den.reserve(den_limbs);
+}
+void rational::shrink_to_fit()
+{
+    this->num.shrink_to_fit();
+    this->den.shrink_to_fit();
+}
+void rational::clear() noexcept
+{
+    this->num.clear();
+    this->den.clear();
+    ++this->den;
+    this->sign = false;
+}
 std::string rational::to_string(bool reverse) const
 {
     std::string str;
-    if(this->den != ubigint(1u)) 
+    if(!this->den.is_one()) 
     {
         str += this->den.to_string(true);
         str += '/';
@@ -308,7 +341,7 @@ std::string rational::to_decimal(rational::size_type digital_digits, bool revers
         str += ".";
     }
     str += qr.first.to_string(true);
-    if(this->sign && this->num != ubigint(0u))
+    if(this->sign && !this->num.is_zero())
         str += "-";
     if(!reverse)
     {
@@ -322,26 +355,77 @@ rational::~rational() noexcept
 {}
 
 // private
-rational::ubigint rational::gcd(rational::ubigint x, rational::ubigint y)
+int rational::compare_small(const ull_type number, bool neg) const noexcept
 {
-    if(x > y) x.swap(y);
-    while(x > 0)
+    if(this->sign != (neg && number != 0))
+        return this->sign ? -1 : 1;
+    int cmp;
+    if(this->den.is_one())
+        cmp = this->num.compare(number);
+    else
     {
-        ubigint q = y % x;
-        y = std::move(x);
-        x = std::move(q);
+        ubigint::const_view n = this->num.view(), d = this->den.view();
+        cmp = cmp_mul_ull(n.data(), n.size(), d.data(), d.size(), number);
     }
-    return y;
+    return this->sign ? -cmp : cmp;
 }
-void rational::reduce()
+rational& rational::add_eq_signed(const rational &rat, bool rat_sign)
 {
-    if(this->den == 0u)
-        throw std::runtime_error("kedixa::rational: denominator is zero.");
-    if(this->num == 0u)
+    if(this == &rat)
     {
-        this->sign = false;
-        this->den  = ubigint(1);
+        rational tmp(rat);
+        return this->add_eq_signed(tmp, rat_sign);
+    }
+    if(rat.num.is_zero())
+        return *this;
+
+    // using common method for fraction plus, g = gcd(a, c)
+    // b/a + d/c = (b*(c/g) + d*(a/g)) / (a/g * c)
+    // and the result can only be reduced by a factor of g
+    ubigint g = gcd(this->den, rat.den), cg;
+    const ubigint *pc = &rat.den;
+    if(!g.is_one())
+    {
+        this->den /= g;
+        cg = rat.den / g;
+        pc = &cg;
     }
+    this->num *= *pc;
+    ubigint t = rat.num * this->den;
+    if(this->sign == rat_sign)
+        this->num += t;
+    else if(this->num >= t)
+        this->num -= t;
+    else
+    {
+        t -= this->num;
+        this->num.swap(t);
+        this->sign = rat_sign;
+    }
+
+    if(this->num.is_zero())
+        this->clear();
+    else if(g.is_one())
+        this->den *= rat.den;
+    else
+    {
+        ubigint g2 = gcd(this->num, g);
+        if(g2.is_one())
+            this->den *= rat.den;
+        else
+        {
+            this->num /= g2;
+            this->den *= rat.den / g2;
+        }
+    }
+    return *this;
+}
+void rational::reduce()
+{
+    if(this->den.is_zero())
+        throw std::runtime_error("kedixa::rational: denominator is zero.");
+    if(this->num.is_zero())
+        this->clear();
     else
     {
         ubigint g = gcd(this->num, this->den);
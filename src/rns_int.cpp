@@ -0,0 +1,166 @@
+#include "kedixa/rns_int.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace kedixa {
+
+namespace {
+
+using uint_type = unsigned_bigint::uint_type;
+
+const uint_type RNS_MIN = uint_type(1) << 30;
+const uint_type RNS_MAX = uint_type(1) << 31;
+
+// a * b mod p for a, b < p in (2^30, 2^31), the quotient estimated in
+// double precision is off by at most one, so are the corrections
+inline uint_type mul_mod(uint_type a, uint_type b, uint_type p, double pinv) noexcept
+{
+    uint64_t q = uint64_t(double(a) * double(b) * pinv);
+    int64_t r = int64_t(uint64_t(a) * b - q * p);
+    r += r < 0 ? int64_t(p) : 0;
+    r -= r >= int64_t(p) ? int64_t(p) : 0;
+    return uint_type(r);
+}
+
+// the primes below 2^31 from the largest, until their product is greater
+// than 2^bits with a bit to spare, sieved in segments by the primes below 2^16
+std::vector<uint_type> largest_primes(unsigned_bigint::size_type bits)
+{
+    const uint_type SQRT = 1u << 16, SEGMENT = 1u << 16;
+    std::vector<uint_type> small;
+    std::vector<bool> composite(SQRT, false);
+    for(uint_type p = 3; p < SQRT; p += 2)
+    {
+        if(composite[p]) continue;
+        small.push_back(p);
+        for(uint_type q = p * p; q < SQRT; q += 2 * p)
+            composite[q] = true;
+    }
+
+    std::vector<uint_type> primes;
+    double total = 0, need = double(bits) + 1;
+    for(uint_type hi = RNS_MAX; total < need; hi -= SEGMENT)
+    {
+        if(hi <= RNS_MIN)
+            throw std::runtime_error("rns_int: too many bits for the primes below 2^31.");
+        // composite[i] for lo + i
+        uint_type lo = hi - SEGMENT;
+        std::fill(composite.begin(), composite.end(), false);
+        for(uint_type p : small)
+            for(uint_type q = (lo + p - 1) / p * p; q < hi; q += p)
+                composite[q - lo] = true;
+        for(uint_type x = hi - 1; x > lo && (total < need); x -= 2)
+        {
+            if(composite[x - lo]) continue;
+            primes.push_back(x);
+            total += std::log2(double(x));
+        }
+    }
+    return primes;
+}
+
+} // namespace
+
+// rns_context
+rns_context::rns_context(const std::vector<uint_type> &moduli)
+    : tree(moduli)
+{
+    if(moduli.empty())
+        throw std::runtime_error("rns_context: moduli must not be empty.");
+    for(uint_type m : moduli)
+    {
+        if(m <= RNS_MIN || m >= RNS_MAX)
+            throw std::runtime_error("rns_context: moduli must be in (2^30, 2^31).");
+        pinv.push_back(1.0 / m);
+    }
+    if(!tree.coprime())
+        throw std::runtime_error("rns_context: moduli are not pairwise coprime.");
+}
+
+std::vector<unsigned_bigint::uint_type> rns_context::to_rns(const ubigint &x) const
+{ return tree.residues(x); }
+unsigned_bigint rns_context::from_rns(const std::vector<uint_type> &rs) const
+{ return tree.crt(rs); }
+
+// rns_int
+rns_int::rns_int(const context_ptr &ctx, const ubigint &value)
+    : ctx(ctx), rs(ctx->to_rns(value))
+{ }
+rns_int::rns_int(const context_ptr &ctx, const uint_type value)
+    : ctx(ctx), rs(ctx->size())
+{
+    const std::vector<uint_type> &m = ctx->moduli();
+    for(size_type i = 0; i < rs.size(); ++i)
+        rs[i] = value % m[i];
+}
+
+rns_int::context_ptr rns_int::make_context(size_type bits)
+{ return std::make_shared<const rns_context>(largest_primes(bits)); }
+rns_int::context_ptr rns_int::make_context(const std::vector<uint_type> &moduli)
+{ return std::make_shared<const rns_context>(moduli); }
+
+// assignment operators, a residue is less than 2^31, the sum of two fits in
+// a limb
+rns_int& rns_int::operator+=(const rns_int &ri)
+{
+    this->check_context(ri);
+    const uint_type *m = ctx->moduli().data(), *b = ri.rs.data();
+    uint_type *a = rs.data();
+    for(size_type i = 0, n = rs.size(); i < n; ++i)
+    {
+        uint_type s = a[i] + b[i];
+        a[i] = s >= m[i] ? s - m[i] : s;
+    }
+    return *this;
+}
+rns_int& rns_int::operator-=(const rns_int &ri)
+{
+    this->check_context(ri);
+    const uint_type *m = ctx->moduli().data(), *b = ri.rs.data();
+    uint_type *a = rs.data();
+    for(size_type i = 0, n = rs.size(); i < n; ++i)
+        a[i] = a[i] - b[i] + (a[i] < b[i] ? m[i] : 0);
+    return *this;
+}
+rns_int& rns_int::operator*=(const rns_int &ri)
+{
+    this->check_context(ri);
+    const uint_type *m = ctx->moduli().data(), *b = ri.rs.data();
+    const double *pinv = ctx->pinv.data();
+    uint_type *a = rs.data();
+    for(size_type i = 0, n = rs.size(); i < n; ++i)
+        a[i] = mul_mod(a[i], b[i], m[i], pinv[i]);
+    return *this;
+}
+
+rns_int rns_int::operator- () const
+{
+    rns_int r(*this);
+    const std::vector<uint_type> &m = ctx->moduli();
+    for(size_type i = 0; i < r.rs.size(); ++i)
+        r.rs[i] = r.rs[i] ? m[i] - r.rs[i] : 0;
+    return r;
+}
+
+// others
+bool rns_int::is_zero() const noexcept
+{ return std::all_of(rs.begin(), rs.end(), [](uint_type r) { return r == 0; }); }
+void rns_int::swap(rns_int &ri) noexcept
+{
+    this->ctx.swap(ri.ctx);
+    this->rs.swap(ri.rs);
+}
+
+// private
+void rns_int::check_context(const rns_int &ri) const
+{
+    if(this->ctx != ri.ctx && this->ctx->moduli() != ri.ctx->moduli())
+        throw std::runtime_error("rns_int: different moduli.");
+}
+
+void swap(rns_int &a, rns_int &b) noexcept
+{ a.swap(b); }
+
+} // namespace kedixa
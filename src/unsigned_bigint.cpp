@@ -1,6 +1,6 @@
 #include "kedixa/unsigned_bigint.h"
 
-#include <cassert>
+#include <algorithm>
 #include <stdexcept>
 #include <cmath>
 
@@ -12,15 +12,11 @@ unsigned_bigint::unsigned_bigint(const uint_type number)
 unsigned_bigint::unsigned_bigint(const vector<uint_type> &_digits)
 { 
     if(_digits.empty()) digits.assign(1, uint_type(0));
-    else digits = _digits;
+    else digits.assign(_digits.begin(), _digits.end());
     this->strip();
 }
 unsigned_bigint::unsigned_bigint(vector<uint_type> &&_digits)
-{
-    if(_digits.empty()) digits.assign(1, uint_type(0));
-    else digits.swap(_digits);
-    this->strip();
-}
+    : unsigned_bigint(static_cast<const vector<uint_type>&>(_digits)) { }
 unsigned_bigint::unsigned_bigint(const std::string& str)
 {
     if(str.empty())
@@ -55,6 +51,8 @@ unsigned_bigint::unsigned_bigint(const std::string& str)
 }
 unsigned_bigint::unsigned_bigint(const char *ch)
     : unsigned_bigint(std::string(ch)) { }
+unsigned_bigint::unsigned_bigint(const_view v)
+{ digits.assign(v.begin(), v.end()); }
 unsigned_bigint::unsigned_bigint(const unsigned_bigint &ubigint)
 { this->digits = ubigint.digits; }
 unsigned_bigint::unsigned_bigint(unsigned_bigint &&ubigint)
@@ -77,107 +75,110 @@ unsigned_bigint& unsigned_bigint::operator+=(const uint_type number)
 { return this->add_eq(number); }
 unsigned_bigint& unsigned_bigint::operator+=(const unsigned_bigint &ubigint)
 { return this->add_eq(ubigint); }
+unsigned_bigint& unsigned_bigint::operator+=(const_view v)
+{ return this->add_eq(v); }
 
 unsigned_bigint& unsigned_bigint::operator-=(const uint_type number)
 { return this->sub_eq(number); }
 unsigned_bigint& unsigned_bigint::operator-=(const unsigned_bigint &ubigint)
 { return this->sub_eq(ubigint); }
+unsigned_bigint& unsigned_bigint::operator-=(const_view v)
+{ return this->sub_eq(v); }
 
 unsigned_bigint& unsigned_bigint::operator*=(const uint_type number)
 { return this->multi_eq(number); }
 unsigned_bigint& unsigned_bigint::operator*=(const unsigned_bigint &ubigint)
 { return this->multi_eq(ubigint); }
+unsigned_bigint& unsigned_bigint::operator*=(const_view v)
+{ return this->multi_eq(v); }
 
 unsigned_bigint& unsigned_bigint::operator/=(const uint_type number)
 { return this->div_eq(number); }
 unsigned_bigint& unsigned_bigint::operator/=(const unsigned_bigint &ubigint)
 { return this->div_eq(ubigint); }
+unsigned_bigint& unsigned_bigint::operator/=(const_view v)
+{ return this->div_eq(v); }
 
 unsigned_bigint& unsigned_bigint::operator%=(const uint_type number)
 { return this->mod_eq(number); }
 unsigned_bigint& unsigned_bigint::operator%=(const unsigned_bigint &ubigint)
 { return this->mod_eq(ubigint); }
+unsigned_bigint& unsigned_bigint::operator%=(const_view v)
+{ return this->mod_eq(v); }
 
 unsigned_bigint& unsigned_bigint::operator&=(const unsigned_bigint &ubigint)
 {
-    auto &a = this->digits;
-    const auto &b = ubigint.digits;
-    if(a.size() > b.size()) a.resize(b.size());
-    for(size_type i = 0; i < a.size(); ++i)
-        a[i] &= b[i];
+    const_view b = ubigint.view();
+    size_type n = std::min(this->digits.size(), b.size());
+    this->digits.resize(n);
+    uint_type *pa = this->digits.data();
+    const uint_type *pb = b.data();
+    for(size_type i = 0; i < n; ++i)
+        pa[i] &= pb[i];
     this->strip();
     return *this;
 }
 
 unsigned_bigint& unsigned_bigint::operator|=(const unsigned_bigint &ubigint)
 {
-    auto &a = this->digits;
-    const auto &b = ubigint.digits;
-    if(a.size() < b.size()) a.resize(b.size(), 0);
-    for(size_type i = 0; i < a.size(); ++i)
-        a[i] |= b[i];
+    const_view b = ubigint.view();
+    if(this->digits.size() < b.size()) this->digits.resize(b.size(), 0);
+    uint_type *pa = this->digits.data();
+    const uint_type *pb = b.data();
+    for(size_type i = 0; i < b.size(); ++i)
+        pa[i] |= pb[i];
     return *this;
 }
 
 unsigned_bigint& unsigned_bigint::operator^=(const unsigned_bigint &ubigint)
 {
-    auto &a = this->digits;
-    const auto &b = ubigint.digits;
-    if(a.size() < b.size()) a.resize(b.size(), 0);
-    for(size_type i = 0; i < a.size(); ++i)
-        a[i] ^= b[i];
+    const_view b = ubigint.view();
+    if(this->digits.size() < b.size()) this->digits.resize(b.size(), 0);
+    uint_type *pa = this->digits.data();
+    const uint_type *pb = b.data();
+    for(size_type i = 0; i < b.size(); ++i)
+        pa[i] ^= pb[i];
     this->strip();
     return *this;
 }
 
 unsigned_bigint& unsigned_bigint::operator<<=(const size_type k)
 {
-    if(*this != 0)
-    {
-        vector<uint_type> &a = this->digits;
-        size_type r = k % UINT_LEN;
-        if(r != 0)
-        {
-            ull_type s = 0;
-            for(size_type i = 0; i < a.size(); ++i)
-            {
-                s |= (ull_type(a[i]) << r);
-                a[i] = uint_type(s);
-                s >>= UINT_LEN;
-            }
-            if(s) a.push_back(uint_type(s));
-        }
-        a.insert(a.begin(), k/UINT_LEN, 0);
-    }
+    if(*this == 0) return *this;
+    size_type len = this->digits.size(), limb_shift = k / UINT_LEN;
+    // a shared or a short buffer would be copied before shifting, the
+    // result is written to a new one directly instead
+    if(this->digits.shared() || len + limb_shift + 1 > this->digits.capacity())
+        return *this = this->shl(k);
+    this->digits.resize(len + limb_shift + 1, 0);
+    uint_type *pa = this->digits.data();
+    pa[len + limb_shift] = mpn::lshift(pa + limb_shift, pa, len, k % UINT_LEN);
+    std::fill(pa, pa + limb_shift, uint_type(0));
+    this->strip();
     return *this;
 }
 
-unsigned_bigint& unsigned_bigint::operator>>=(const size_type k) noexcept
+unsigned_bigint& unsigned_bigint::operator>>=(const size_type k)
 {
-    vector<uint_type> &a = this->digits;
-    if(k/UINT_LEN >= a.size()) a.assign({0});
-    else
+    size_type len = this->digits.size(), limb_shift = k / UINT_LEN;
+    if(limb_shift >= len)
     {
-        a.erase(a.begin(), a.begin()+k/UINT_LEN);
-        size_type r = k % UINT_LEN;
-        if(r != 0)
-        {
-            ull_type s = 0;
-            for(size_type i = a.size() - 1; i != (size_type) -1; --i)
-            {
-                s |= ull_type(a[i]);
-                a[i] = uint_type(s >> r);
-                s <<= UINT_LEN;
-            }
-        }
-        this->strip();
+        this->digits.assign(1, uint_type(0));
+        return *this;
     }
+    // a shared buffer is not written, the result goes to a new one
+    if(this->digits.shared())
+        return *this = this->shr(k);
+    uint_type *pa = this->digits.data();
+    mpn::rshift(pa, pa + limb_shift, len - limb_shift, k % UINT_LEN);
+    this->digits.resize(len - limb_shift);
+    this->strip();
     return *this;
 }
 
 // conversion operators
 unsigned_bigint::operator bool() const noexcept
-{ return *this != 0; }
+{ return !this->is_zero(); }
 unsigned_bigint::operator uint_type() const noexcept
 { return this->digits[0]; }
 unsigned_bigint::operator ull_type() const noexcept
@@ -338,17 +339,11 @@ unsigned_bigint  unsigned_bigint::operator+ () const
 
 // bitwise operators
 unsigned_bigint operator<<(const unsigned_bigint &lhs, const unsigned_bigint::size_type k)
-{
-    unsigned_bigint tmp = lhs;
-    return std::move(tmp <<= k);
-}
+{ return lhs.shl(k); }
 unsigned_bigint operator<<(unsigned_bigint &&lhs, const unsigned_bigint::size_type k)
 { return std::move(lhs <<= k); }
 unsigned_bigint operator>>(const unsigned_bigint &lhs, const unsigned_bigint::size_type k)
-{
-    unsigned_bigint tmp = lhs;
-    return std::move(tmp >>= k);
-}
+{ return lhs.shr(k); }
 unsigned_bigint operator>>(unsigned_bigint &&lhs, const unsigned_bigint::size_type k)
 { return std::move(lhs >>= k); }
 
@@ -434,43 +429,37 @@ bool operator!=(const unsigned_bigint &lhs, const unsigned_bigint &rhs) noexcept
 
 // others
 int unsigned_bigint::compare(const unsigned_bigint &ubigint) const noexcept
+{ return this->compare(ubigint.view()); }
+int unsigned_bigint::compare(const_view v) const noexcept
 {
-    const auto &a = this->digits, &b = ubigint.digits;
-    size_type lena = a.size(), lenb = b.size();
-    if(lena > lenb) return 1;
-    else if(lena < lenb) return -1;
-    for(size_type i = lena - 1; i != (size_type)-1; --i)
-        if(a[i] != b[i]) return (a[i] < b[i]) ? -1 : 1;
-    return 0;
+    size_type lena = this->digits.size(), lenb = v.size();
+    if(lena != lenb) return (lena < lenb) ? -1 : 1;
+    return mpn::cmp(this->digits.data(), v.data(), lena);
 }
+bool unsigned_bigint::is_zero() const noexcept
+{ return this->digits.size() == 1 && this->digits[0] == 0; }
+bool unsigned_bigint::is_one() const noexcept
+{ return this->digits.size() == 1 && this->digits[0] == 1; }
+int unsigned_bigint::sgn() const noexcept
+{ return this->is_zero() ? 0 : 1; }
 
 unsigned_bigint
 unsigned_bigint::add(const unsigned_bigint &ubigint) const
 {
-    const vector<uint_type> *pa, *pb;
-    if(this->digits.size() > ubigint.digits.size())
-        pa = &(this->digits), pb = &(ubigint.digits);
-    else pa = &(ubigint.digits), pb = &(this->digits);
-    const vector<uint_type> &a = *pa, &b = *pb;
-    size_type lena = a.size(), lenb = b.size();
-    vector<uint_type> c(lena);
-    ull_type carry = 0;
-    size_type i = 0;
-    for(; i < lenb; ++i)
+    ull_type r;
+    if(this->is_word() && ubigint.is_word()
+       && !_k_help::add_overflow(this->word(), ubigint.word(), r))
     {
-        carry += a[i];
-        carry += b[i];
-        c[i] = uint_type(carry);
-        carry >>= UINT_LEN;
+        unsigned_bigint tmp;
+        tmp.assign_ull(r);
+        return tmp;
     }
-    for(; i < lena; ++i)
-    {
-        carry += a[i];
-        c[i] = uint_type(carry);
-        carry >>= UINT_LEN;
-    }
-    if(carry) c.push_back(uint_type(carry));
-    return std::move(unsigned_bigint(std::move(c)));
+    const_view a = this->view(), b = ubigint.view();
+    if(a.size() < b.size()) std::swap(a, b);
+    limbs c(a.size() + 1);
+    uint_type *pc = c.data();
+    pc[a.size()] = mpn::add(pc, a.data(), a.size(), b.data(), b.size());
+    return unsigned_bigint(std::move(c), true);
 }
 unsigned_bigint
 unsigned_bigint::add(const uint_type number) const
@@ -481,41 +470,39 @@ unsigned_bigint::add(const uint_type number) const
 }
 unsigned_bigint&
 unsigned_bigint::add_eq(const unsigned_bigint &ubigint)
+{ return this->add_eq(ubigint.view()); }
+unsigned_bigint&
+unsigned_bigint::add_eq(const_view b)
 {
-    size_type lena = this->digits.size(), lenb = ubigint.digits.size();
-    if(lena < lenb) this->digits.resize(lenb, 0), lena = lenb;
-
-    ull_type carry = 0;
-    vector<uint_type> &a = this->digits;
-    const vector<uint_type> &b = ubigint.digits;
-    size_type i = 0;
-    for(; i < lenb; ++i)
+    ull_type r;
+    if(this->is_word() && is_word(b) && !_k_help::add_overflow(this->word(), word(b), r))
+    {
+        this->assign_ull(r);
+        return *this;
+    }
+    size_type lena = this->digits.size(), lenb = b.size();
+    uint_type carry;
+    if(lena < lenb)
     {
-        carry += ull_type(a[i]) + ull_type(b[i]);
-        a[i] = uint_type(carry);
-        carry >>= UINT_LEN;
+        this->digits.resize(lenb, 0);
+        uint_type *pa = this->digits.data();
+        carry = mpn::add(pa, b.data(), lenb, pa, lena);
     }
-    for(; carry && i < lena; ++i)
+    else
     {
-        if(a[i]==UINT_TYPE_MAX) a[i] = 0;
-        else ++a[i], carry = 0;
+        uint_type *pa = this->digits.data();
+        carry = mpn::add(pa, pa, lena, b.data(), lenb);
     }
-    if(carry) a.push_back(uint_type(carry));
+    if(carry) this->digits.push_back(carry);
     return *this;
 }
 unsigned_bigint&
 unsigned_bigint::add_eq(const uint_type number)
 {
-    vector<uint_type> &a = this->digits;
-    ull_type carry = ull_type(number) + ull_type(a[0]);
-    a[0] = uint_type(carry);
-    carry >>= UINT_LEN;
-    for(size_type i = 1; carry && i < a.size(); ++i)
-    {
-        if(a[i]==UINT_TYPE_MAX) a[i] = 0;
-        else ++a[i], carry = 0;
-    }
-    if(carry) a.push_back(uint_type(carry));
+    size_type len = this->digits.size();
+    uint_type *pa = this->digits.data();
+    if(mpn::add_1(pa, pa, len, number))
+        this->digits.push_back(uint_type(1));
     return *this;
 }
 
@@ -535,50 +522,34 @@ unsigned_bigint::sub(const uint_type number) const
 }
 unsigned_bigint&
 unsigned_bigint::sub_eq(const unsigned_bigint &ubigint)
+{ return this->sub_eq(ubigint.view()); }
+unsigned_bigint&
+unsigned_bigint::sub_eq(const_view b)
 {
-    size_type len1 = this->digits.size(), len2 = ubigint.digits.size();
-    if(len1 < len2)
-        throw std::underflow_error("unsigned_bigint:: subtraction underflow.");
-    vector<uint_type> &a = this->digits;
-    const vector<uint_type> &b = ubigint.digits;
-
-    llint_type x = 0;
-    size_type i = 0;
-    for(; i < len2; ++i)
-    {
-        x += a[i];
-        x -= b[i];
-        a[i] = uint_type(x);
-        x >>= UINT_LEN;
-    }
-    bool borrow = 0;
-    if(x < 0) borrow = true;
-    for(; borrow && i < len1; ++i)
+    if(this->is_word() && is_word(b))
     {
-        if(a[i] == 0) a[i] = UINT_TYPE_MAX;
-        else --a[i], borrow = false;
+        ull_type x = this->word(), y = word(b);
+        if(x < y)
+            throw std::underflow_error("unsigned_bigint:: subtraction underflow.");
+        this->assign_ull(x - y);
+        return *this;
     }
-    if(borrow)
+    if(this->compare(b) < 0)
         throw std::underflow_error("unsigned_bigint:: subtraction underflow.");
+    size_type len = this->digits.size();
+    uint_type *pa = this->digits.data();
+    mpn::sub(pa, pa, len, b.data(), b.size());
     this->strip();
     return *this;
 }
 unsigned_bigint&
 unsigned_bigint::sub_eq(const uint_type number)
 {
-    vector<uint_type> &a = this->digits;
-    llint_type x = llint_type(a[0]);
-    x -= llint_type(number);
-    bool borrow = false;
-    a[0] = uint_type(x);
-    if(x < 0) borrow = true;
-    for(size_type i = 0; borrow && i < a.size(); ++i)
-    {
-        if(a[i] == 0) a[i] = UINT_TYPE_MAX;
-        else --a[i], borrow = false;
-    }
-    if(borrow)
+    if(*this < number)
         throw std::underflow_error("unsigned_bigint:: subtraction underflow.");
+    size_type len = this->digits.size();
+    uint_type *pa = this->digits.data();
+    mpn::sub_1(pa, pa, len, number);
     this->strip();
     return *this;
 }
@@ -586,95 +557,67 @@ unsigned_bigint::sub_eq(const uint_type number)
 unsigned_bigint
 unsigned_bigint::multi(const unsigned_bigint &ubigint) const
 {
-    // special case
-    if(*this == 0 || ubigint == 0) return unsigned_bigint(uint_type(0));
-    if(*this == 1) return ubigint;
-    if(ubigint == 1) return *this;
-    // special end
-
-    const vector<uint_type> &a = this->digits, &b = ubigint.digits;
-    size_type lena = a.size(), lenb = b.size();
-    // if both a and b are long enough,
-    // use divide and conquer algorithm
-    if(lena > MULTI_HINT && lenb > MULTI_HINT)
-    {
-        unsigned_bigint a1, a2, b1, b2;
-        vector<uint_type> &va1 = a1.digits, &va2 = a2.digits,
-                          &vb1 = b1.digits, &vb2 = b2.digits;
-        size_type len_max = std::max(lena, lenb);
-        size_type m = len_max / 2;
-
-        // divide a and b to two parts
-        // lower m digits, and higher (lenx - m) digits
-        va2.assign(a.begin(), a.begin() + std::min(m, lena));
-        if(lena > m) va1.assign(a.begin() + m, a.end());
-        else va1.assign(1, uint_type(0));
-        vb2.assign(b.begin(), b.begin() + std::min(m, lenb));
-        if(lenb > m) vb1.assign(b.begin() + m, b.end());
-        else vb1.assign(1, uint_type(0));
-        // conquer (x = unsigned_bigint(1u) << (m*UINT_LEN))
-        //   (a1*x + a2)*(b1*x + b2)
-        // = a1*b1*x^2 + (a1*b2 + a2*b1)*x + a2*b2
-        // = a1*b1*x^2 + ((a1+a2)*(b1+b2)-a1*b1-a2*b2)*x + a2*b2
-        unsigned_bigint a1b1 = a1 * b1, a2b2 = a2 * b2;
-        unsigned_bigint a1b2_a2b1 = (a1 + a2)*(b1 + b2) - a1b1 - a2b2;
-        a1b1 <<= (m * 2 * UINT_LEN);
-        a1b2_a2b1 <<= (m * UINT_LEN);
-        return std::move(std::move(a1b1) + a1b2_a2b1 + a2b2);
-    }
-    // else if they are not long
-    // use ordinary method
-    vector<uint_type> result(lena + lenb, 0);
-    // multi b[0]
-    ull_type x = ull_type(b[0]), y = 0;
-    if(x != 0)
-    {
-        for(size_type j = 0; j < lena; ++j)
-        {
-            y += x * a[j];
-            result[j] = uint_type(y);
-            y >>= UINT_LEN;
-        }
-        result[lena] = uint_type(y); // carry
-    }
-    // multi b[1...]
-    for(size_type i = 1; i < lenb; ++i)
+    ull_type r;
+    if(this->is_word() && ubigint.is_word()
+       && !_k_help::mul_overflow(this->word(), ubigint.word(), r))
     {
-        x = ull_type(b[i]), y = 0;
-        if(x == 0) continue;
-        size_type j, k;
-        for(j = 0, k = i; j < lena; ++j, ++k)
-        {
-            y += x * a[j] + result[k];
-            result[k] = uint_type(y);
-            y >>= UINT_LEN;
-        }
-        result[k] = uint_type(y);
+        unsigned_bigint tmp;
+        tmp.assign_ull(r);
+        return tmp;
     }
-    unsigned_bigint tmp(std::move(result));
-    return std::move(tmp);
+    if(*this == 0 || ubigint == 0) return unsigned_bigint(uint_type(0));
+    return unsigned_bigint(product(this->view(), ubigint.view()), true);
 }
 unsigned_bigint
 unsigned_bigint::multi(const uint_type number) const
 {
     if(number == 0) return unsigned_bigint(uint_type(0));
     if(number == 1) return *this;
-    const vector<uint_type> &a = this->digits;
-    vector<uint_type> c(a.size());
-    ull_type x = ull_type(number), y = 0;
-    for(size_type i = 0; i < a.size(); ++i)
-    {
-        y += x * a[i];
-        c[i] = uint_type(y);
-        y >>= UINT_LEN;
-    }
-    if(y) c.push_back(uint_type(y));
-    return unsigned_bigint(std::move(c));
+    const_view a = this->view();
+    limbs c(a.size() + 1);
+    uint_type *pc = c.data();
+    pc[a.size()] = mpn::mul_1(pc, a.data(), a.size(), number);
+    return unsigned_bigint(std::move(c), true);
 }
 unsigned_bigint&
 unsigned_bigint::multi_eq(const unsigned_bigint &ubigint)
+{ return this->multi_eq(ubigint.view()); }
+unsigned_bigint&
+unsigned_bigint::multi_eq(const_view b)
 {
-    *this = this->multi(ubigint);
+    ull_type r;
+    if(this->is_word() && is_word(b) && !_k_help::mul_overflow(this->word(), word(b), r))
+    {
+        this->assign_ull(r);
+        return *this;
+    }
+    size_type lena = this->digits.size(), lenb = b.size();
+    if(lenb == 1) return this->multi_eq(b[0]);
+    if(*this == 0) return *this;
+    // squaring and Karatsuba need a separate result
+    if(this->aliases(b) || (lena >= mpn::MUL_KARATSUBA_THRESHOLD
+                            && lenb >= mpn::MUL_KARATSUBA_THRESHOLD))
+    {
+        this->assign_digits(product(this->view(), b));
+        this->strip();
+        return *this;
+    }
+
+    // Replace a[i] by a[i] * b from the highest limb downward, the lower
+    // limbs of a are not overwritten until they are consumed, so the
+    // product is built in the existing buffer.
+    this->digits.resize(lena + lenb, 0);
+    uint_type *pa = this->digits.data();
+    const uint_type *pb = b.data();
+    for(size_type i = lena - 1; i != (size_type)-1; --i)
+    {
+        uint_type x = pa[i];
+        pa[i] = 0;
+        if(x == 0) continue;
+        uint_type carry = mpn::addmul_1(pa + i, pb, lenb, x);
+        mpn::add_1(pa + i + lenb, pa + i + lenb, lena - i, carry);
+    }
+    this->strip();
     return *this;
 }
 unsigned_bigint&
@@ -686,15 +629,10 @@ unsigned_bigint::multi_eq(const uint_type number)
         return *this;
     }
     if(number == 1) return *this;
-    vector<uint_type> &a = this->digits;
-    ull_type x = ull_type(number), y = 0;
-    for(size_type i = 0; i < a.size(); ++i)
-    {
-        y += x * a[i];
-        a[i] = uint_type(y);
-        y >>= UINT_LEN;
-    }
-    if(y) a.push_back(uint_type(y));
+    size_type len = this->digits.size();
+    uint_type *pa = this->digits.data();
+    uint_type carry = mpn::mul_1(pa, pa, len, number);
+    if(carry) this->digits.push_back(carry);
     return *this;
 }
 
@@ -706,8 +644,21 @@ unsigned_bigint::div(const uint_type number) const
 { return std::move((this->div_mod(number)).first); }
 unsigned_bigint&
 unsigned_bigint::div_eq(const unsigned_bigint &ubigint)
+{ return this->div_eq(ubigint.view()); }
+unsigned_bigint&
+unsigned_bigint::div_eq(const_view b)
 {
-    *this = std::move((this->div_mod(ubigint)).first);
+    if(b.size() == 1)
+        return this->div_eq(b[0]);
+    if(this->compare(b) < 0)
+    {
+        this->digits.assign(1, uint_type(0));
+        return *this;
+    }
+    limbs q;
+    this->div_mod_eq(b, &q);
+    this->assign_digits(std::move(q));
+    this->strip();
     return *this;
 }
 unsigned_bigint&
@@ -717,16 +668,9 @@ unsigned_bigint::div_eq(const uint_type number)
         throw std::runtime_error("unsigned_bigint: divide by zero.");
     if(number == 1)
         return *this;
-    vector<uint_type> &a = this->digits;
-    ull_type x = ull_type(number), y = 0;
-    size_type i = a.size() - 1;
-    for(; i != (size_type)-1; --i)
-    {
-        y <<= UINT_LEN;
-        y += a[i];
-        a[i] = uint_type(y/x);
-        y %= x;
-    }
+    size_type len = this->digits.size();
+    uint_type *pa = this->digits.data();
+    mpn::divrem_1(pa, pa, len, number);
     this->strip();
     return *this;
 }
@@ -739,8 +683,15 @@ unsigned_bigint::mod(const uint_type number) const
 { return std::move((this->div_mod(number)).second); }
 unsigned_bigint&
 unsigned_bigint::mod_eq(const unsigned_bigint &ubigint)
+{ return this->mod_eq(ubigint.view()); }
+unsigned_bigint&
+unsigned_bigint::mod_eq(const_view b)
 {
-    *this = std::move((this->div_mod(ubigint)).second);
+    if(b.size() == 1)
+        return this->mod_eq(b[0]);
+    if(this->compare(b) < 0)
+        return *this;
+    this->div_mod_eq(b, nullptr);
     return *this;
 }
 unsigned_bigint&
@@ -748,19 +699,9 @@ unsigned_bigint::mod_eq(const uint_type number)
 {
     if(number == 0)
         throw std::runtime_error("unsigned_bigint: divide by zero.");
-    if(number == 1)
-        return (*this = unsigned_bigint(uint_type(0)));
-    vector<uint_type> &a = this->digits;
-    ull_type x = ull_type(number), y = 0;
-    size_type i = a.size() - 1;
-    for(; i != (size_type)-1; --i)
-    {
-        y <<= UINT_LEN;
-        y += a[i];
-        a[i] = uint_type(y/x);
-        y %= x;
-    }
-    *this = unsigned_bigint(y);
+    const limbs &a = this->digits;
+    uint_type r = mpn::mod_1(a.data(), a.size(), number);
+    this->digits.assign(1, r);
     return *this;
 }
 
@@ -773,74 +714,11 @@ unsigned_bigint::div_mod(const unsigned_bigint &ubigint) const
     if(*this < ubigint)
         return std::make_pair(unsigned_bigint(uint_type(0)), unsigned_bigint(*this));
 
-    // implement the algorithm in Knuth[The Art of Computer Programming]
-    unsigned_bigint dividend = *this, divisor = ubigint, rem;
-    vector<uint_type> q; // save the quot
-    // 1. normalize
-    ull_type base = ull_type(1) << UINT_LEN;
-    size_type lshift = 0;
-    uint_type back = divisor.digits.back();
-    while(back < base/2) back<<=1, ++lshift;
-    dividend <<= lshift, divisor <<= lshift;
-    vector<uint_type> &a = dividend.digits;
-    const vector<uint_type> &b = divisor.digits;
-    size_type sz_b = b.size(); // size of divisor
-    a.push_back(uint_type(0)); // for u0
-
-    // 2. loop
-    const uint_type &v1 = b[sz_b-1], &v2 = b[sz_b-2];
-    q.resize(a.size() - b.size());
-    for(size_type i = q.size() - 1; i != (size_type)-1; --i)
-    {
-        // get the estimated value of q
-        ull_type qh;
-        uint_type &u0 = a[i+sz_b], &u1 = a[i+sz_b-1], &u2 = a[i+sz_b-2];
-        qh = (u0 * base + u1) / v1;
-        if(qh * v2 > base * (u0 * base + u1 - qh * v1) + u2) --qh;
-
-        // multi and subtract
-        llint_type borrow = 0;
-        ull_type carry = 0;
-        for(size_type j = 0; j < sz_b; ++j)
-        {
-            carry += qh * b[j];
-            borrow += a[i+j];
-            borrow -= uint_type(carry);
-            a[i+j] = uint_type(borrow);
-            borrow >>= UINT_LEN;
-            carry >>= UINT_LEN;
-        }
-        borrow += a[i+sz_b];
-        borrow -= carry;
-        a[i+sz_b] = uint_type(borrow);
-        borrow >>= UINT_LEN;
-        while(borrow < 0)
-        {
-            // add divisor back to dividend
-            assert(borrow==-1);
-            carry = 0;
-            for(size_type j = 0; j < sz_b; ++j)
-            {
-                carry += a[i+j];
-                carry += b[j];
-                a[i+j] = uint_type(carry);
-                carry >>= UINT_LEN;
-            }
-            carry += a[i+sz_b];
-            a[i+sz_b] = uint_type(carry);
-            carry >>= UINT_LEN;
-            borrow += carry;
-            --qh; // don't forget
-        }
-        assert(borrow == 0);
-        q[i] = uint_type(qh);
-
-    }
-    // 3. get quotient and real remainder
-    unsigned_bigint quotient(std::move(q));
-    dividend.strip();
-    dividend >>= lshift;
-    return std::make_pair(std::move(quotient), std::move(dividend));
+    const_view a = this->view(), b = ubigint.view();
+    limbs q(a.size() - b.size() + 1), r(b.size());
+    mpn::divrem(q.data(), r.data(), a.data(), a.size(), b.data(), b.size());
+    return std::make_pair(unsigned_bigint(std::move(q), true),
+                          unsigned_bigint(std::move(r), true));
 }
 std::pair<unsigned_bigint, unsigned_bigint>
 unsigned_bigint::div_mod(const uint_type number) const
@@ -849,28 +727,53 @@ unsigned_bigint::div_mod(const uint_type number) const
         throw std::runtime_error("unsigned_bigint: divide by zero.");
     if(number == 1)
         return std::make_pair(unsigned_bigint(*this), unsigned_bigint(uint_type(0)));
-    unsigned_bigint tmp = *this;
-    vector<uint_type> &a = tmp.digits;
-    ull_type x = ull_type(number), y = 0;
-    size_type i = a.size() - 1;
-    for(; i != (size_type)-1; --i)
-    {
-        y <<= UINT_LEN;
-        y += a[i];
-        a[i] = uint_type(y/x);
-        y %= x;
-    }
-    tmp.strip();
-    return std::make_pair(std::move(tmp), unsigned_bigint(uint_type(y)));
+    const_view a = this->view();
+    limbs q(a.size());
+    uint_type r = mpn::divrem_1(q.data(), a.data(), a.size(), number);
+    return std::make_pair(unsigned_bigint(std::move(q), true), unsigned_bigint(r));
+}
+
+unsigned_bigint
+unsigned_bigint::powmod(const unsigned_bigint &exp, const unsigned_bigint &mod) const
+{
+    if(mod == 0)
+        throw std::runtime_error("unsigned_bigint: divide by zero.");
+    const_view b = this->view(), e = exp.view(), m = mod.view();
+    limbs r(m.size());
+    mpn::powm(r.data(), b.data(), b.size(), e.data(), e.size(), m.data(), m.size());
+    return unsigned_bigint(std::move(r), true);
+}
+
+unsigned_bigint unsigned_bigint::invert(const unsigned_bigint &mod) const
+{
+    if(mod == 0)
+        throw std::runtime_error("unsigned_bigint: divide by zero.");
+    const_view a = this->view(), m = mod.view();
+    size_type an = a.size(), mn = m.size();
+    vector<uint_type> buf(an + 2 * mn + std::max(an, mn));
+    uint_type *ap = buf.data(), *mp = ap + an, *sp = mp + mn, *gp = sp + mn;
+    std::copy(a.begin(), a.end(), ap);
+    std::copy(m.begin(), m.end(), mp);
+    std::ptrdiff_t sn;
+    size_type gn = mpn::gcdext(gp, sp, sn, ap, an, mp, mn);
+    if(gn != 1 || gp[0] != 1)
+        throw std::runtime_error("unsigned_bigint: the inverse does not exist.");
+    // 1 = s * a (mod m), where |s| <= m
+    unsigned_bigint s(const_view(sp, sn < 0 ? -sn : sn));
+    if(sn < 0) s = mod - s;
+    if(s >= mod) s -= mod;
+    return s;
 }
 
 void unsigned_bigint::swap(unsigned_bigint &ubigint) noexcept
 { this->digits.swap(ubigint.digits); }
+unsigned_bigint::const_view unsigned_bigint::view() const noexcept
+{ return const_view(this->digits.data(), this->digits.size()); }
 
 std::string unsigned_bigint::to_string(bool reverse) const
 {
     vector<uint_type> v;
-    const vector<uint_type> a = this->digits;
+    const limbs &a = this->digits;
     v.reserve(a.size() * TOSTR_HINT); // roughly allocate memory
     ull_type y;
     for(size_type i = a.size() - 1; i != size_type(-1); --i)
@@ -919,20 +822,253 @@ std::string unsigned_bigint::to_string(bool reverse) const
     return std::move(result);
 }
 
+unsigned_bigint::size_type unsigned_bigint::bit_length() const noexcept
+{
+    size_type n = digits.size();
+    uint_type top = digits[n-1];
+    return top ? n * UINT_LEN - mpn::clz(top) : 0;
+}
+unsigned_bigint::size_type unsigned_bigint::popcount() const noexcept
+{ return mpn::popcount(digits.data(), digits.size()); }
+unsigned_bigint::size_type unsigned_bigint::count_trailing_zeros() const noexcept
+{
+    const uint_type *p = digits.data();
+    size_type n = digits.size(), i = 0;
+    while(i < n && p[i] == 0) ++i;
+    return i < n ? i * UINT_LEN + mpn::ctz(p[i]) : 0;
+}
+bool unsigned_bigint::test_bit(size_type k) const noexcept
+{
+    size_type i = k / UINT_LEN;
+    return i < digits.size() && (digits.data()[i] >> (k % UINT_LEN) & 1);
+}
+unsigned_bigint& unsigned_bigint::set_bit(size_type k)
+{
+    size_type i = k / UINT_LEN;
+    if(i >= digits.size()) digits.resize(i + 1);
+    digits[i] |= uint_type(1) << (k % UINT_LEN);
+    return *this;
+}
+unsigned_bigint& unsigned_bigint::clear_bit(size_type k)
+{
+    // nothing is written if the bit is clear, so a shared buffer is kept
+    if(this->test_bit(k))
+    {
+        digits[k / UINT_LEN] &= ~(uint_type(1) << (k % UINT_LEN));
+        this->strip();
+    }
+    return *this;
+}
+unsigned_bigint& unsigned_bigint::flip_bit(size_type k)
+{
+    if(this->test_bit(k)) return this->clear_bit(k);
+    return this->set_bit(k);
+}
+unsigned_bigint unsigned_bigint::shl(size_type k) const
+{
+    size_type len = digits.size(), limb_shift = k / UINT_LEN;
+    if(len == 1 && digits[0] == 0) return unsigned_bigint();
+    limbs r(len + limb_shift + 1);
+    uint_type *pr = r.data();
+    pr[len + limb_shift] = mpn::lshift(pr + limb_shift, digits.data(), len, k % UINT_LEN);
+    return unsigned_bigint(std::move(r), true);
+}
+unsigned_bigint unsigned_bigint::shr(size_type k) const
+{
+    size_type len = digits.size(), limb_shift = k / UINT_LEN;
+    if(limb_shift >= len) return unsigned_bigint();
+    limbs r(len - limb_shift);
+    mpn::rshift(r.data(), digits.data() + limb_shift, len - limb_shift, k % UINT_LEN);
+    return unsigned_bigint(std::move(r), true);
+}
+unsigned_bigint unsigned_bigint::extract_bits(size_type pos, size_type len) const
+{
+    size_type n = digits.size(), first = pos / UINT_LEN;
+    if(len == 0 || first >= n) return unsigned_bigint();
+    // the bits span at most rn + 1 limbs from first
+    size_type rn = (len + UINT_LEN - 1) / UINT_LEN, sn = std::min(n - first, rn + 1);
+    limbs r(sn);
+    mpn::rshift(r.data(), digits.data() + first, sn, pos % UINT_LEN);
+    if(sn >= rn)
+    {
+        r.resize(rn);
+        if(len % UINT_LEN)
+            r[rn-1] &= (uint_type(1) << (len % UINT_LEN)) - 1;
+    }
+    return unsigned_bigint(std::move(r), true);
+}
+
 unsigned_bigint::size_type unsigned_bigint::size() const noexcept
 { return digits.size(); }
+unsigned_bigint::size_type unsigned_bigint::capacity() const noexcept
+{ return digits.capacity(); }
+void unsigned_bigint::reserve(size_type limbs)
+{ digits.reserve(limbs); }
+void unsigned_bigint::shrink_to_fit()
+{ digits.shrink_to_fit(); }
+void unsigned_bigint::clear() noexcept
+{ digits.assign(1, uint_type(0)); }
 
 unsigned_bigint::~unsigned_bigint() noexcept
 { }
 
 // private:
+unsigned_bigint::unsigned_bigint(limbs &&_digits, bool)
+{
+    if(_digits.empty()) digits.assign(1, uint_type(0));
+    else digits.swap(_digits);
+    this->strip();
+}
+
 void unsigned_bigint::strip() noexcept
 {
-    vector<uint_type> &a = this->digits;
-    size_type sz = a.size() - 1;
-    while(sz > 0 && a[sz] == 0) --sz;
-    a.resize(sz + 1);
-    return;
+    const limbs &a = this->digits;
+    size_type len = mpn::normalize(a.data(), a.size());
+    this->digits.resize(len ? len : 1);
+}
+
+bool unsigned_bigint::aliases(const_view v) const noexcept
+{
+    std::less<const uint_type*> less;
+    const uint_type *first = this->digits.data();
+    return !less(v.data(), first) && less(v.data(), first + this->digits.capacity());
+}
+
+unsigned_bigint::limbs unsigned_bigint::product(const_view a, const_view b)
+{
+    if(a.size() < b.size()) std::swap(a, b);
+    limbs c(a.size() + b.size());
+    if(a.data() == b.data() && a.size() == b.size())
+        mpn::sqr(c.data(), a.data(), a.size());
+    else
+        mpn::mul(c.data(), a.data(), a.size(), b.data(), b.size());
+    return c;
+}
+
+void unsigned_bigint::assign_digits(limbs &&_digits)
+{
+    if(this->digits.capacity() >= _digits.size() && !this->digits.shared())
+        this->digits.assign(_digits.begin(), _digits.end());
+    else
+        this->digits.swap(_digits);
+}
+
+unsigned_bigint&
+unsigned_bigint::rsub_eq(const_view b)
+{
+    if(this->compare(b) > 0)
+        throw std::underflow_error("unsigned_bigint:: subtraction underflow.");
+    size_type len = this->digits.size();
+    this->digits.resize(b.size(), 0);
+    uint_type *pa = this->digits.data();
+    mpn::sub(pa, b.data(), b.size(), pa, len);
+    this->strip();
+    return *this;
+}
+
+void unsigned_bigint::div_mod_eq(const_view b, limbs *quot)
+{
+    size_type lena = this->digits.size(), lenb = b.size();
+    if(quot) quot->assign(lena - lenb + 1, uint_type(0));
+    uint_type *pa = this->digits.data();
+    mpn::divrem(quot ? quot->data() : nullptr, pa, pa, lena, b.data(), lenb);
+    this->digits.resize(lenb);
+    this->strip();
+}
+
+unsigned_bigint&
+unsigned_bigint::add_eq_ull(const ull_type number)
+{
+    uint_type lo = uint_type(number), hi = uint_type(number >> UINT_LEN);
+    if(hi == 0) return this->add_eq(lo);
+    const uint_type b[2] = {lo, hi};
+    return this->add_eq(const_view(b, 2));
+}
+unsigned_bigint&
+unsigned_bigint::sub_eq_ull(const ull_type number)
+{
+    uint_type lo = uint_type(number), hi = uint_type(number >> UINT_LEN);
+    if(hi == 0) return this->sub_eq(lo);
+    const uint_type b[2] = {lo, hi};
+    return this->sub_eq(const_view(b, 2));
+}
+unsigned_bigint&
+unsigned_bigint::rsub_eq_ull(const ull_type number)
+{
+    if(this->compare_ull(number) > 0)
+        throw std::underflow_error("unsigned_bigint:: subtraction underflow.");
+    this->assign_ull(number - static_cast<ull_type>(*this));
+    return *this;
+}
+unsigned_bigint&
+unsigned_bigint::multi_eq_ull(const ull_type number)
+{
+    uint_type lo = uint_type(number), hi = uint_type(number >> UINT_LEN);
+    if(hi == 0) return this->multi_eq(lo);
+    size_type len = this->digits.size();
+    this->digits.resize(len + 2, 0);
+    uint_type *pa = this->digits.data();
+    // a[i] * lo and a[i-1] * hi are accumulated with separate carries,
+    // so that neither of them overflows ull_type
+    ull_type carry_lo = 0, carry_hi = 0;
+    uint_type prev = 0;
+    for(size_type i = 0; i < len + 2; ++i)
+    {
+        uint_type cur = pa[i];
+        carry_lo += ull_type(cur) * lo;
+        carry_hi += ull_type(prev) * hi + uint_type(carry_lo);
+        pa[i] = uint_type(carry_hi);
+        carry_lo >>= UINT_LEN;
+        carry_hi >>= UINT_LEN;
+        prev = cur;
+    }
+    this->strip();
+    return *this;
+}
+unsigned_bigint::ull_type
+unsigned_bigint::div_eq_ull(const ull_type number)
+{
+    if(number == 0)
+        throw std::runtime_error("unsigned_bigint: divide by zero.");
+    uint_type lo = uint_type(number), hi = uint_type(number >> UINT_LEN);
+    size_type len = this->digits.size();
+    if(hi == 0)
+    {
+        uint_type *pa = this->digits.data();
+        uint_type r = mpn::divrem_1(pa, pa, len, lo);
+        this->strip();
+        return r;
+    }
+    if(this->compare_ull(number) < 0)
+    {
+        ull_type r = static_cast<ull_type>(*this);
+        this->digits.assign(1, uint_type(0));
+        return r;
+    }
+    const uint_type b[2] = {lo, hi};
+    limbs q;
+    this->div_mod_eq(const_view(b, 2), &q);
+    ull_type r = static_cast<ull_type>(*this);
+    this->assign_digits(std::move(q));
+    this->strip();
+    return r;
+}
+void unsigned_bigint::assign_ull(const ull_type number)
+{
+    // the limbs are in the object, only a shared or reserved buffer is on
+    // the heap
+    uint_type hi = uint_type(number >> UINT_LEN);
+    this->digits.resize(hi ? 2 : 1);
+    uint_type *pa = this->digits.data();
+    pa[0] = uint_type(number);
+    if(hi) pa[1] = hi;
+}
+int unsigned_bigint::compare_ull(const ull_type number) const noexcept
+{
+    if(this->digits.size() > 2) return 1;
+    ull_type x = static_cast<ull_type>(*this);
+    if(x == number) return 0;
+    return (x < number) ? -1 : 1;
 }
 
 // non-member function
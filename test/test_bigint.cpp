@@ -43,6 +43,16 @@ void check_relation()
     assert(int_max != int_min);
     assert(three <= three);
     assert(ten >= int_min);
+
+    // native 64-bit integers
+    bigint big("18446744073709551616"), i64min("-9223372036854775808");
+    assert(i64min == INT64_MIN && i64min < INT64_MAX && i64min < 0 && 0 > i64min);
+    assert(big > UINT64_MAX && -big < INT64_MIN && bigint("18446744073709551615") == UINT64_MAX);
+    assert(neg_one == -1 && neg_one != 1u && neg_one < 0u && 0ULL > neg_one);
+    assert(zero == 0 && zero >= 0LL && zero <= 0ULL && -zero == 0);
+    assert(neg_ten.compare(-11) > 0 && neg_ten.compare(-10) == 0 && neg_ten.compare(-9) < 0);
+    assert(zero.is_zero() && one.is_one() && !neg_one.is_one() && !ten.is_zero());
+    assert(zero.sgn() == 0 && neg_ten.sgn() == -1 && int_max.sgn() == 1);
 }
 
 void check_add_sub()
@@ -57,6 +67,18 @@ void check_add_sub()
     assert(--b1 == -2);
     b1 = zero;
     assert(++b1 == one);
+
+    bigint b2("-98765432109876543210"), b3("12345678901234567890");
+    bigint b4 = b3;
+    b4 += b2;
+    assert(b4 == bigint("-86419753208641975320"));
+    b4 -= b2;
+    assert(b4 == b3);
+    b4 -= b4;
+    assert(b4 == zero);
+    b4 = b3;
+    b4 += b4;
+    assert(b4 == b3 * 2);
 }
 
 void check_multi_div()
@@ -72,6 +94,22 @@ void check_multi_div()
     assert(ten / neg_three == -4);
     assert(ten % neg_three == -2);
     assert(int_min / neg_one == int_max + 1);
+
+    bigint b1("-98765432109876543210"), b2("12345678901234567890");
+    bigint b3 = b1;
+    b3 /= b2;
+    assert(b3 == -9);
+    b3 = b1;
+    b3 %= b2;
+    assert(b3 == bigint("12345678001234567800"));
+    b3 = b2;
+    b3 %= b1;
+    assert(b3 == bigint("-86419753208641975320"));
+    b3 = b1;
+    b3 /= b3;
+    assert(b3 == one);
+    b3 %= b3;
+    assert(b3 == zero);
 }
 
 void check_hash()
@@ -83,6 +121,11 @@ void check_hash()
     st.insert(neg_ten);
     st.insert(int_max);
     assert(st.find(zero) != st.end());
+
+    hash<bigint> h;
+    assert(h(one) != h(neg_one) && h(ten) != h(neg_ten));
+    assert(h(bigint("-4294967298")) != h(bigint("-8589934593")));
+    assert(h(-zero) == h(zero));
 }
 
 void check_convert()
@@ -103,6 +146,270 @@ void check_others()
     assert((ten >> 12) == zero);
     assert(bigint(-7) >> 1 == -4);
     assert(bigint(-9) >> 2 == -3);
+    assert(bigint(-8) >> 2 == -2 && bigint(-8) >> 0 == -8 && bigint(-1) >> 100 == -1);
+
+    bigint b1(-12345);
+    b1.reserve(32);
+    assert(b1.capacity() >= 32 && b1 == -12345);
+    b1.clear();
+    assert(b1 == zero && b1.capacity() >= 32);
+    b1.shrink_to_fit();
+    assert(b1 == zero && b1.capacity() < 32);
+}
+
+void check_powmod()
+{
+    bigint five(5), neg_five(-5);
+    assert(three.powmod(three, five) == 2);
+    assert(neg_three.powmod(three, five) == 3);     // -27 = 5 * -6 + 3
+    assert(neg_three.powmod(three, neg_five) == -2); // -27 = -5 * 5 - 2
+    assert(three.powmod(three, neg_five) == -3);
+    assert(neg_three.powmod(bigint(2), five) == 4);
+    assert(ten.powmod(three, five) == 0 && ten.powmod(three, neg_five) == 0);
+    for(int x = -20; x <= 20; ++x)
+    for(int m = -9; m <= 9; ++m)
+    {
+        if(m == 0) continue;
+        bigint bx(x), bm(m);
+        assert(bx.powmod(three, bm) == (bx * bx * bx) % bm);
+    }
+    bool thrown = false;
+    try { three.powmod(neg_one, five); }
+    catch(const std::runtime_error &) { thrown = true; }
+    assert(thrown);
+}
+
+void check_native()
+{
+    bigint b1("123456789012345678901234567890");
+    assert(b1 + 10 == b1 + ten);
+    assert(b1 * 3 == b1 + b1 + b1);
+    assert(ten * -3LL == -30);
+    assert(-3 * ten == -30);
+    assert(10 - three == 7);
+    assert(three - 10 == -7);
+    assert(neg_ten + 10u == zero);
+    assert(ten / -3 == -4);
+    assert(ten % -3 == -2);
+    assert(neg_ten % 3 == 2);
+    assert(10 % neg_three == -2);
+    assert(zero / -3 == zero && !(zero / -3 < zero));
+
+    int64_t i64 = -9223372036854775807LL - 1;
+    uint64_t u64 = 18446744073709551615ULL;
+    bigint bi64 = zero + i64, bu64 = zero + u64;
+    assert(bi64.to_string() == "-9223372036854775808");
+    assert(bu64.to_string() == "18446744073709551615");
+    assert(bu64 + i64 == bigint("9223372036854775807"));
+    assert(b1 * u64 == b1 * bu64);
+    assert(b1 * i64 == b1 * bi64);
+    assert(b1 / u64 == b1 / bu64);
+    assert(b1 % u64 == b1 % bu64);
+    assert(-b1 / i64 == -b1 / bi64);
+    assert(b1 % i64 == b1 % bi64);
+
+    mt19937_64 gen(rd());
+    for(size_t i = 0; i < 100; ++i)
+    {
+        int64_t x = gen();
+        if(x == 0) continue;
+        bigint bx = zero + x;
+        assert(b1 + x == b1 + bx);
+        assert(b1 - x == b1 - bx);
+        assert(x - b1 == bx - b1);
+        assert(b1 * x == b1 * bx);
+        assert(b1 / x == b1 / bx);
+        assert(b1 % x == b1 % bx);
+        assert(-b1 / x == -b1 / bx);
+        assert(-b1 % x == -b1 % bx);
+    }
+
+    // rvalue operands
+    bigint b2 = b1 + b1 + b1 - b1 * 3;
+    assert(b2 == zero);
+    assert(ten - (three + three) == 4);
+    assert((ten + ten) / (neg_three + neg_three) == -4);
+    assert((ten + ten) % (neg_three + neg_three) == -4);
+    assert(-((neg_ten + neg_ten) * (three + three)) == 120);
+}
+
+// on the two's complement, the bitwise operators agree with those of
+// int64_t on small numbers
+void check_bitwise()
+{
+    mt19937_64 gen(20201018);
+    auto rand64 = [&gen]() {
+        int64_t x = int64_t(gen() >> (gen() % 64));
+        return gen() % 2 ? -x : x;
+    };
+    for(int t = 0; t < 2000; ++t)
+    {
+        int64_t x = rand64(), y = rand64();
+        bigint a(to_string(x)), b(to_string(y));
+        assert((a & b) == bigint(to_string(x & y)));
+        assert((a | b) == bigint(to_string(x | y)));
+        assert((a ^ b) == bigint(to_string(x ^ y)));
+        assert(~a == bigint(to_string(~x)));
+        unsigned k = gen() % 70;
+        assert((a >> k) == bigint(to_string(k < 64 ? x >> k : (x < 0 ? -1 : 0))));
+        bigint c = a;
+        c &= b, c |= a, c ^= b;
+        assert(c == bigint(to_string(((x & y) | x) ^ y)));
+        c >>= k % 64, c <<= k % 64;
+        assert(c == bigint(to_string((((x & y) | x) ^ y) >> (k % 64))) * (bigint(1) << (k % 64)));
+    }
+
+    // large numbers, the identities of the two's complement
+    bigint p("123456789012345678901234567890123456789"), n = -p * p;
+    assert(~~n == n && ~n == -n - 1);
+    assert((n & -n) == (bigint(1) << unsigned(n.to_ubigint().count_trailing_zeros())));
+    assert((n | ~n) == -1 && (n & ~n) == 0 && (n ^ n) == 0 && (n ^ ~n) == -1);
+    assert((p & n) + (p | n) == p + n && (p ^ n) == (p | n) - (p & n));
+    assert((n >> 100) == bigint(-((-n - 1) >> 100)) - 1);
+
+    // a negative zero is a zero
+    for(const bigint &z : {bigint("-0"), bigint(kedixa::unsigned_bigint(0u), true)})
+    {
+        assert(~z == -1 && (z >> 3) == 0 && (z >> 0) == 0);
+        assert((bigint(5) | z) == 5 && (z | bigint(-7)) == -7);
+        assert((bigint(5) & z) == 0 && (z & bigint(-7)) == 0);
+        assert((bigint(5) ^ z) == 5 && (z ^ bigint(-7)) == -7 && (z ^ z) == 0);
+    }
+}
+
+void check_compact()
+{
+    // the sign lives in the limbs of the magnitude
+    static_assert(sizeof(bigint) == sizeof(kedixa::unsigned_bigint), "bigint has no sign field");
+
+    // the sign stays with the object through copies, moves and swaps
+    bigint a("-123456789012345678901234567890"), b("987654321098765432109876543210");
+    bigint c(a), d(std::move(c));
+    assert(d == a && d < 0);
+    swap(d, b);
+    assert(b == a && d > 0 && d.to_string() == "987654321098765432109876543210");
+    b = d;
+    assert(b == d && b > 0);
+    b = -a;
+    assert(b > 0 && b.to_ubigint() == a.to_ubigint());
+    assert(a.to_ubigint() > 0u && -a == bigint(a.to_ubigint()));
+
+    // signed addition and subtraction against 64-bit integers
+    mt19937_64 gen(rd());
+    for(int i = 0; i < 10000; ++i)
+    {
+        int64_t x = int64_t(gen()) >> (gen() % 64), y = int64_t(gen()) >> (gen() % 64);
+        x /= 2, y /= 2;
+        bigint bx = zero + x, by = zero + y;
+        assert(bx + by == x + y && bx - by == x - y);
+        bigint t(bx);
+        t += by;
+        assert(t == x + y);
+        t = bx;
+        t -= by;
+        assert(t == x - y);
+        assert((t -= t) == 0 && t.sgn() == 0);
+    }
+    bigint m("-340282366920938463463374607431768211456"); // -2^128
+    assert(m + (-m) == 0 && m - m == 0 && (m - 1) + 1 == m && (1 - m) - 1 == -m);
+    assert((m + 1).to_string() == "-340282366920938463463374607431768211455");
+    assert((-m - 1).to_string() == "340282366920938463463374607431768211455");
+    bigint n(m);
+    n += -m + 5;
+    assert(n == 5);
+    n -= m;
+    assert(n == 5 - m);
+
+    // zero has no sign, however it is made
+    for(const bigint &z : {bigint("-0"), bigint(kedixa::unsigned_bigint(0u), true),
+                           bigint(-1) / 2 + 1, bigint(-3) * 0, -bigint(0)})
+    {
+        assert(z.sgn() == 0 && z == 0 && !(z < 0) && z == zero && z.to_string() == "0");
+        assert((z << 3) == 0 && (z << 3).sgn() == 0 && std::hash<bigint>()(z) == std::hash<bigint>()(zero));
+        bigint c(z), d(std::move(c));
+        assert(d.sgn() == 0 && c.sgn() == 0);
+    }
+    assert(bigint(-1) / 2 == -1 && bigint(-1) / 3u == -1 && bigint(-6) / 3 == -2);
+}
+
+void check_word()
+{
+    // the arithmetic in a machine word, and its overflow into limbs
+    bigint u64max("18446744073709551615"), two64("18446744073709551616");
+    bigint two32("4294967296"), two32m1("4294967295"), two32p1("4294967297");
+    assert(u64max + 1 == two64 && 1 + u64max == two64 && u64max - (-one) == two64);
+    assert(-u64max - 1 == -two64 && -u64max + neg_one == -two64);
+    assert(two64 - 1 == u64max && -two64 + 1 == -u64max && two64 - u64max == 1);
+    assert(two32 * two32 == two64 && two32 * -two32 == -two64);
+    assert(two32m1 * two32p1 == u64max && -two32m1 * -two32p1 == u64max);
+    assert(u64max * zero == 0 && (neg_ten * zero).sgn() == 0 && (zero * neg_ten).sgn() == 0);
+    assert(ten - ten == 0 && (neg_ten - neg_ten).sgn() == 0 && (neg_ten + ten).sgn() == 0);
+    bigint t(u64max);
+    t += u64max;
+    assert(t == two64 * 2 - 2);
+    t = u64max;
+    t *= u64max;
+    assert(t == bigint("340282366920938463426481119284349108225"));
+    t = -u64max;
+    t -= u64max;
+    assert(t == -(two64 * 2 - 2));
+
+    mt19937_64 gen(rd());
+    for(int i = 0; i < 10000; ++i)
+    {
+        uint64_t x = gen() >> (gen() % 64), y = gen() >> (gen() % 64);
+        bigint bx = zero + x, by = zero + y, nx = -bx;
+        bigint p = bx * by, q(nx);
+        q *= by;
+        assert(p == -q && (y == 0 || p / by == bx) && (bx + by) - by == bx);
+        assert(nx - by == -(bx + by) && nx + by == by - bx);
+    }
+}
+
+void check_div_modes()
+{
+    typedef std::pair<bigint, bigint> qr;
+    assert(bigint(7).fdiv_qr(2) == qr(3, 1) && bigint(-7).fdiv_qr(2) == qr(-4, 1));
+    assert(bigint(7).fdiv_qr(-2) == qr(-4, -1) && bigint(-7).fdiv_qr(-2) == qr(3, -1));
+    assert(bigint(7).cdiv_qr(2) == qr(4, -1) && bigint(-7).cdiv_qr(2) == qr(-3, -1));
+    assert(bigint(7).cdiv_qr(-2) == qr(-3, 1) && bigint(-7).cdiv_qr(-2) == qr(4, 1));
+    assert(bigint(7).ediv_qr(2) == qr(3, 1) && bigint(-7).ediv_qr(2) == qr(-4, 1));
+    assert(bigint(7).ediv_qr(-2) == qr(-3, 1) && bigint(-7).ediv_qr(-2) == qr(4, 1));
+    assert(bigint(-6).cdiv_qr(3) == qr(-2, 0) && bigint(-6).ediv_qr(-3) == qr(2, 0));
+    assert(zero.cdiv_qr(neg_ten) == qr(0, 0) && zero.ediv_qr(ten).second.sgn() == 0);
+    assert(bigint(-7).fmod(2) == 1 && bigint(7).fmod(bigint(-2)) == -1);
+    assert(neg_ten.ediv_qr(INT64_MIN) == qr(1, bigint("9223372036854775798")));
+    assert(neg_ten.cdiv_qr(UINT64_MAX) == qr(0, -10));
+    bool thrown = false;
+    try { ten.ediv_qr(0); } catch(const std::runtime_error&) { thrown = true; }
+    assert(thrown);
+
+    mt19937_64 gen(rd());
+    auto rand_big = [&gen](int limbs) {
+        bigint r(0);
+        for(int i = 0; i < limbs; ++i)
+            r = (r << 32) + (unsigned long long)(gen() >> 32);
+        return gen() % 2 ? -r : r;
+    };
+    for(int i = 0; i < 3000; ++i)
+    {
+        bigint n = rand_big(gen() % 6), d = rand_big(1 + gen() % 4);
+        if(d == 0) continue;
+        int64_t small = int64_t(gen()) >> (gen() % 64);
+        if(small == 0) small = 1;
+        bigint ds = zero + small;
+        qr f = n.fdiv_qr(d), c = n.cdiv_qr(d), e = n.ediv_qr(d);
+        assert(f == n.div_mod(d) && f.first == n / d && f.second == n % d);
+        assert(f.first * d + f.second == n && n.fmod(d) == f.second);
+        assert(c.first * d + c.second == n && e.first * d + e.second == n);
+        assert(f.second.sgn() * d.sgn() >= 0 && c.second.sgn() * d.sgn() <= 0 && e.second >= 0);
+        bigint ad = d.sgn() < 0 ? -d : d;
+        assert(-f.second < ad && f.second < ad && -c.second < ad && c.second < ad && e.second < ad);
+        assert(n.fdiv_qr(small) == n.fdiv_qr(ds) && n.cdiv_qr(small) == n.cdiv_qr(ds));
+        assert(n.ediv_qr(small) == n.ediv_qr(ds) && n.fmod(small) == n.fdiv_qr(ds).second);
+        uint32_t limb = uint32_t(gen()) | 1;
+        assert(n.ediv_qr(limb) == n.ediv_qr(bigint(0) + limb));
+    }
 }
 
 void check()
@@ -114,4 +421,10 @@ void check()
     check_hash();
     check_convert();
     check_others();
+    check_bitwise();
+    check_native();
+    check_powmod();
+    check_compact();
+    check_word();
+    check_div_modes();
 }
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+#include <exception>
+
+#include "kedixa/modint.h"
+#include "kedixa/number_theory.h"
+
+using namespace std;
+using ubig = kedixa::unsigned_bigint;
+using kedixa::modint;
+using kedixa::random_bits;
+
+mt19937 gen(20201018);
+
+void check();
+
+int main()
+{
+    check();
+    return 0;
+}
+
+void check_small()
+{
+    auto ctx = modint::make_context(ubig(101u));
+    modint a(ctx, 7u), b(ctx, 100u), c(ctx, ubig(1000u));
+    assert(a.value() == 7 && c.value() == 1000 % 101);
+    assert((a + b).value() == 6 && (a - b).value() == 8);
+    assert((a * b).value() == 700 % 101 && (-a).value() == 94);
+    assert((a / b) * b == a && (a / a).value() == 1);
+    assert(a.pow(ubig(100u)).value() == 1 && a.pow(ubig(0u)).value() == 1);
+    assert(a.pow(ubig(1u)) == a && a.pow(ubig(3u)).value() == 343 % 101);
+    assert(modint(ctx).pow(ubig(5u)).is_zero() && modint(ctx).pow(ubig(0u)).value() == 1);
+    auto unit = modint::make_context(ubig(1u));
+    assert(modint(unit, 3u).pow(ubig(0u)).is_zero());
+    assert(modint(ctx).is_zero() && -modint(ctx) == modint(ctx));
+    assert(a.to_string() == "7" && a.modulus() == 101);
+
+    // another context of the same modulus works together
+    modint d(modint::make_context(ubig(101u)), 7u);
+    assert(d == a && (d * b).value() == 700 % 101);
+
+    bool caught = false;
+    try { a + modint(modint::make_context(ubig(103u)), 1u); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+
+    caught = false;
+    auto ctx15 = modint::make_context(ubig(15u));
+    try { modint(ctx15, 5u).inverse(); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught && (modint(ctx15, 7u).inverse().value() == 13));
+
+    caught = false;
+    try { modint::make_context(ubig(16u)); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+}
+
+void check_large()
+{
+    for(size_t n : {1, 2, 3, 8, 33, 70})
+    {
+        ubig m = random_bits(32 * n, gen).set_bit(32 * n - 1);
+        if(m % 2 == 0) m += 1;
+        auto ctx = modint::make_context(m);
+        for(int t = 0; t < 10; ++t)
+        {
+            ubig x = random_bits(32 * n + 32, gen), y = random_bits(32 * n, gen);
+            modint a(ctx, x), b(ctx, y);
+            ubig xm = x % m, ym = y % m;
+            assert(a.value() == xm && b.value() == ym);
+            assert((a + b).value() == (xm + ym) % m);
+            assert((a - b).value() == (xm + m - ym) % m);
+            assert((a * b).value() == xm * ym % m);
+            modint s(a);
+            s *= s;
+            assert(s.value() == xm * xm % m);
+            ubig e = random_bits(64, gen);
+            assert(a.pow(e).value() == xm.powmod(e, m));
+            if(!b.is_zero())
+            {
+                try { assert((a / b) * b == a); }
+                catch(const runtime_error &) { } // not coprime
+            }
+        }
+    }
+
+    // Fermat's little theorem with the prime 2^127 - 1
+    ubig p = (ubig(1u) << 127) - 1u;
+    auto ctx = modint::make_context(p);
+    modint a(ctx, random_bits(128, gen));
+    assert(a.pow(p - 1u).value() == 1);
+    assert(a.pow(p - 2u) == a.inverse());
+}
+
+void check()
+{
+    check_small();
+    check_large();
+}
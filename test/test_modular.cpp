@@ -0,0 +1,205 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+#include <exception>
+
+#include "kedixa/modular.h"
+#include "kedixa/number_theory.h"
+
+using namespace std;
+using ubig = kedixa::unsigned_bigint;
+using kedixa::montgomery_context;
+using kedixa::barrett_context;
+using kedixa::multi_mod_context;
+using kedixa::random_bits;
+
+mt19937 gen(20201018);
+
+void check();
+
+int main()
+{
+    check();
+    return 0;
+}
+
+void check_montgomery()
+{
+    const size_t sizes[] = {1, 2, 3, 5, 31, 32, 33, 64, 101};
+    for(size_t n : sizes)
+    {
+        ubig m = random_bits(32 * n, gen).set_bit(32 * n - 1);
+        if(m % 2 == 0) m += 1;
+        montgomery_context ctx(m);
+        assert(ctx.modulus() == m && ctx.size() >= n);
+        ubig R = ubig(1u) << (32 * ctx.size());
+
+        for(int t = 0; t < 10; ++t)
+        {
+            ubig a = random_bits(32 * n, gen) % m, b = random_bits(32 * n, gen) % m;
+            ubig am = ctx.to_mont(a), bm = ctx.to_mont(b);
+            assert(am == a * R % m && ctx.from_mont(am) == a);
+            assert(ctx.from_mont(ctx.mul(am, bm)) == a * b % m);
+            assert(ctx.from_mont(ctx.sqr(am)) == a * a % m);
+            assert(ctx.reduce(am * bm) == ctx.mul(am, bm));
+            // to_mont accepts numbers not less than the modulus
+            ubig big = random_bits(96 * n, gen);
+            assert(ctx.from_mont(ctx.to_mont(big)) == big % m);
+
+            // the in place versions keep the buffer
+            ubig x = am;
+            x.reserve(ctx.size());
+            size_t cap = x.capacity();
+            ctx.mul_eq(x, bm);
+            ctx.sqr_eq(x);
+            assert(x.capacity() == cap);
+            assert(ctx.from_mont(x) == (a * b % m) * (a * b % m) % m);
+        }
+
+        // a^e mod m on limb buffers
+        ubig a = random_bits(32 * n, gen) % m, e = random_bits(64, gen);
+        vector<uint32_t> x(ctx.size(), 0), r(ctx.size(), 0);
+        for(size_t i = 0; i < a.size(); ++i) x[i] = a.view()[i];
+        ctx.to_mont(x.data(), x.data());
+        r[0] = 1;
+        ctx.to_mont(r.data(), r.data());
+        for(size_t i = e.size() * 32; i-- > 0; )
+        {
+            ctx.sqr(r.data(), r.data());
+            if((e.view()[i / 32] >> (i % 32)) & 1)
+                ctx.mul(r.data(), r.data(), x.data());
+        }
+        ctx.from_mont(r.data(), r.data());
+        assert(ubig(r) == a.powmod(e, m));
+    }
+
+    montgomery_context one(ubig(1u));
+    assert(one.to_mont(ubig(5u)) == 0 && one.mul(ubig(0u), ubig(0u)) == 0);
+
+    bool caught = false;
+    try { montgomery_context ctx(ubig(10u)); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+}
+
+void check_barrett()
+{
+    const size_t sizes[] = {1, 2, 3, 5, 31, 32, 33, 64, 101};
+    for(size_t n : sizes)
+    {
+        ubig m = random_bits(32 * n, gen).set_bit(32 * n - 1);
+        barrett_context ctx(m);
+        assert(ctx.modulus() == m && ctx.size() == n);
+        for(int t = 0; t < 10; ++t)
+        {
+            ubig a = random_bits(32 * n, gen) % m, b = random_bits(32 * n, gen) % m;
+            assert(ctx.mul(a, b) == a * b % m);
+            assert(ctx.sqr(a) == a * a % m);
+            for(size_t xn : {size_t(1), n, 2 * n, 2 * n + 1, 5 * n + 3})
+            {
+                ubig x = random_bits(32 * xn, gen);
+                assert(ctx.reduce(x) == x % m);
+            }
+            ubig x = a;
+            x.reserve(n);
+            size_t cap = x.capacity();
+            ctx.mul_eq(x, b);
+            ctx.sqr_eq(x);
+            assert(x.capacity() == cap && x == (a * b % m) * (a * b % m) % m);
+        }
+    }
+
+    // mu does not fit in n + 1 limbs when the modulus is a power of B
+    for(size_t k : {0, 1, 2, 40})
+    {
+        ubig m = ubig(1u) << (32 * k);
+        barrett_context ctx(m);
+        for(int t = 0; t < 10; ++t)
+        {
+            ubig x = random_bits(64 * k + 64, gen);
+            assert(ctx.reduce(x) == x % m);
+        }
+        ubig a = m - 1;
+        assert(ctx.sqr(a) == a * a % m);
+    }
+
+    bool caught = false;
+    try { barrett_context ctx(ubig(0u)); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+}
+
+void check_multi_mod()
+{
+    // no moduli, and moduli of 1
+    multi_mod_context empty(vector<uint32_t>{});
+    assert(empty.product() == 1 && empty.residues(random_bits(160, gen)).empty());
+    assert(empty.coprime() && empty.crt({}) == 0);
+    assert(kedixa::multi_mod(ubig(7u), {1, 1, 3}) == vector<uint32_t>({0, 0, 1}));
+
+    // small, large and repeated moduli, with trees of every shape
+    for(size_t k : {1, 2, 3, 7, 64, 300, 1000})
+    {
+        vector<uint32_t> mods(k);
+        for(auto &m : mods)
+            m = gen() % 3 ? gen() % 1000 + 1 : uint32_t(gen()) | 1;
+        multi_mod_context ctx(mods);
+        ubig prod(1u);
+        for(uint32_t m : mods) prod *= m;
+        assert(ctx.moduli() == mods && ctx.product() == prod);
+        for(size_t n : {size_t(1), size_t(3), k / 4 + 1, k * 3})
+        {
+            ubig x = random_bits(32 * n, gen);
+            vector<uint32_t> rs = ctx.residues(x);
+            assert(rs.size() == k);
+            for(size_t i = 0; i < k; ++i)
+                assert(rs[i] == x % mods[i]);
+        }
+    }
+
+    // distinct primes are pairwise coprime
+    vector<uint32_t> primes;
+    for(uint32_t p = 4000000001u; primes.size() < 500; p += 2)
+    {
+        bool prime = true;
+        for(uint32_t d = 3; d * d <= p && prime; d += 2)
+            prime = p % d != 0;
+        if(prime) primes.push_back(p);
+    }
+    primes.push_back(2), primes.push_back(9), primes.push_back(125);
+    multi_mod_context ctx(primes);
+    assert(ctx.coprime());
+    for(int t = 0; t < 5; ++t)
+    {
+        ubig x = random_bits(32 * (gen() % 510 + 1), gen) % ctx.product();
+        vector<uint32_t> rs = ctx.residues(x);
+        assert(ctx.crt(rs) == x && kedixa::crt(rs, primes) == x);
+        // the residues may be not reduced
+        for(size_t i = 0; i < rs.size(); ++i)
+            if(uint64_t(rs[i]) + primes[i] <= UINT32_MAX) rs[i] += primes[i];
+        assert(ctx.crt(rs) == x);
+    }
+
+    bool caught = false;
+    multi_mod_context shared({6, 35, 11, 14});
+    assert(!shared.coprime());
+    try { shared.crt({1, 2, 3, 4}); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+    caught = false;
+    try { ctx.crt({1, 2, 3}); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+    caught = false;
+    try { multi_mod_context zero({3, 0}); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+}
+
+void check()
+{
+    check_montgomery();
+    check_barrett();
+    check_multi_mod();
+}
@@ -0,0 +1,286 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "kedixa/mpn.h"
+#include "kedixa/unsigned_bigint.h"
+
+using namespace std;
+namespace mpn = kedixa::mpn;
+using limb = mpn::limb_type;
+using ubig = kedixa::unsigned_bigint;
+using limbs = vector<limb>;
+
+mt19937 gen(20201018);
+
+void check();
+
+int main()
+{
+    check();
+    return 0;
+}
+
+// random limbs, with many 0 and ~0 limbs to exercise the carries
+limbs random_limbs(size_t n)
+{
+    limbs v(n);
+    for(auto &x : v)
+    {
+        unsigned k = gen() % 4;
+        x = (k == 0) ? 0 : (k == 1) ? ~limb(0) : limb(gen());
+    }
+    if(n > 0 && v[n-1] == 0) v[n-1] = 1;
+    return v;
+}
+
+// (rp, an + bn) = (ap, an) * (bp, bn) by the schoolbook method
+limbs naive_mul(const limbs &a, const limbs &b)
+{
+    limbs r(a.size() + b.size(), 0);
+    for(size_t i = 0; i < b.size(); ++i)
+        r[i + a.size()] = mpn::addmul_1(r.data() + i, a.data(), a.size(), b[i]);
+    return r;
+}
+
+void check_add_sub()
+{
+    limbs a(4, ~limb(0)), b{1}, r(4);
+    assert(mpn::add(r.data(), a.data(), 4, b.data(), 1) == 1);
+    assert(mpn::normalize(r.data(), 4) == 0);
+    assert(mpn::sub(r.data(), r.data(), 4, b.data(), 1) == 1);
+    assert(mpn::cmp(r.data(), a.data(), 4) == 0);
+    assert(mpn::add_1(r.data(), r.data(), 0, 5) == 5);
+
+    for(int t = 0; t < 100; ++t)
+    {
+        size_t n = gen() % 40 + 1;
+        limbs x = random_limbs(n), y = random_limbs(n), s(n), d(n);
+        limb carry = mpn::add_n(s.data(), x.data(), y.data(), n);
+        limb borrow = mpn::sub_n(d.data(), s.data(), y.data(), n);
+        assert(d == x && carry == borrow);
+        borrow = mpn::sub_n(d.data(), x.data(), y.data(), n);
+        assert(borrow == (mpn::cmp(x.data(), y.data(), n) < 0));
+    }
+}
+
+void check_mul()
+{
+    limbs a{3, 5}, r(2);
+    assert(mpn::mul_1(r.data(), a.data(), 2, 7) == 0 && r == limbs({21, 35}));
+    assert(mpn::submul_1(r.data(), a.data(), 2, 7) == 0 && r == limbs({0, 0}));
+    assert(mpn::submul_1(r.data(), a.data(), 2, 1) == 1);
+
+    // sizes around and far above the Karatsuba threshold
+    const size_t sizes[] = {1, 2, 17, 31, 32, 33, 64, 65, 100, 150};
+    for(size_t an : sizes)
+    for(size_t bn : sizes)
+    {
+        if(bn > an) continue;
+        limbs x = random_limbs(an), y = random_limbs(bn), r(an + bn);
+        mpn::mul(r.data(), x.data(), an, y.data(), bn);
+        assert(r == naive_mul(x, y));
+    }
+    for(size_t n : sizes)
+    {
+        limbs x = random_limbs(n), r(2 * n);
+        mpn::sqr(r.data(), x.data(), n);
+        assert(r == naive_mul(x, x));
+    }
+}
+
+void check_div()
+{
+    limbs a{7, 0, 1}, q(3);
+    assert(mpn::divrem_1(q.data(), a.data(), 3, 2) == 1);
+    assert(q == limbs({3, limb(1) << 31, 0}));
+    assert(mpn::mod_1(a.data(), 3, 2) == 1);
+
+    for(int t = 0; t < 300; ++t)
+    {
+        size_t dn = gen() % 20 + 1, an = dn + gen() % 20;
+        limbs x = random_limbs(an), d = random_limbs(dn);
+        limbs q(an - dn + 1), r(dn), back(an + 1, 0);
+        mpn::divrem(q.data(), r.data(), x.data(), an, d.data(), dn);
+        // r < d and q * d + r == x
+        assert(mpn::cmp(r.data(), d.data(), dn) < 0);
+        mpn::mul(back.data(), q.data(), q.size(), d.data(), dn);
+        assert(mpn::add(back.data(), back.data(), an + 1, r.data(), dn) == 0);
+        assert(back[an] == 0 && limbs(back.begin(), back.end() - 1) == x);
+
+        // the remainder can be written over the dividend
+        limbs y = x;
+        mpn::divrem(nullptr, y.data(), y.data(), an, d.data(), dn);
+        assert(limbs(y.begin(), y.begin() + dn) == r);
+
+        // the same with the scratch space given
+        limbs ws(mpn::divrem_itch(an, dn)), q2(q.size()), r2(dn);
+        mpn::divrem(q2.data(), r2.data(), x.data(), an, d.data(), dn, ws.data());
+        assert(q2 == q && r2 == r);
+    }
+}
+
+void check_montgomery()
+{
+    for(limb m0 : {1u, 3u, 0xFFFFFFFFu, 0x12345679u})
+        assert(limb(m0 * mpn::mont_inverse(m0)) == ~limb(0));
+
+    // redc(x * B^n) == x mod m
+    for(int t = 0; t < 50; ++t)
+    {
+        size_t n = gen() % 40 + 1;
+        limbs m = random_limbs(n), x = random_limbs(n), r(n), rx(n);
+        m[0] |= 1;
+        limbs tp(2 * n, 0);
+        std::copy(x.begin(), x.end(), tp.begin() + n);
+        mpn::divrem(nullptr, rx.data(), x.data(), n, m.data(), n);
+        if(mpn::cmp(x.data(), m.data(), n) >= 0)
+            mpn::divrem(nullptr, tp.data() + n, x.data(), n, m.data(), n);
+        mpn::redc(r.data(), tp.data(), m.data(), n, mpn::mont_inverse(m[0]));
+        assert(r == rx);
+    }
+
+    // mont_mul(a, b) == redc(a * b), on odd and even sizes
+    for(int t = 0; t < 50; ++t)
+    {
+        size_t n = gen() % 70 + 1;
+        limbs m = random_limbs(n), a = random_limbs(n), b = random_limbs(n);
+        m[0] |= 1;
+        a[n-1] = b[n-1] = 0;
+        limbs r(n), rr(n), tp(2 * n), ws(mpn::mont_mul_itch(n));
+        limb minv = mpn::mont_inverse(m[0]);
+        mpn::mul_n(tp.data(), a.data(), b.data(), n, ws.data());
+        mpn::redc(rr.data(), tp.data(), m.data(), n, minv);
+        mpn::mont_mul(r.data(), a.data(), b.data(), m.data(), n, minv, ws.data());
+        assert(r == rr);
+        limbs sq(2 * n);
+        mpn::sqr_n(sq.data(), b.data(), n, ws.data());
+        mpn::mul_n(tp.data(), b.data(), b.data(), n, ws.data());
+        assert(sq == tp);
+        mpn::redc(rr.data(), tp.data(), m.data(), n, minv);
+        mpn::mont_mul(b.data(), b.data(), b.data(), m.data(), n, minv, ws.data());
+        assert(b == rr);
+    }
+
+    // 3^(2^64) mod 1000 = 3^16 mod 1000, the order of 3 is 100 and
+    // 2^64 mod 100 = 16
+    limbs b{3}, e{0, 0, 1}, m{1000}, r(1);
+    mpn::powm(r.data(), b.data(), 1, e.data(), 3, m.data(), 1);
+    assert(r[0] == 721);
+
+    // even moduli, with a base longer than the product of two residues,
+    // against repeated multiplications
+    for(int t = 0; t < 30; ++t)
+    {
+        size_t n = gen() % 12 + 2, bn = 2 * n + gen() % 10;
+        limbs m = random_limbs(n), base = random_limbs(bn), x(n), want(n, 0), got(n);
+        m[0] &= ~limb(1), m[n-1] |= 1;
+        limb e = gen() % 100 + 1;
+        mpn::divrem(nullptr, x.data(), base.data(), bn, m.data(), n);
+        want[0] = 1;
+        for(limb i = 0; i < e; ++i)
+        {
+            limbs p(2 * n);
+            mpn::mul(p.data(), want.data(), n, x.data(), n);
+            mpn::divrem(nullptr, want.data(), p.data(), 2 * n, m.data(), n);
+        }
+        mpn::powm(got.data(), base.data(), bn, &e, 1, m.data(), n);
+        assert(got == want);
+    }
+}
+
+void check_shift()
+{
+    limbs a{0x80000001u, 0x1}, r(2);
+    assert(mpn::lshift(r.data(), a.data(), 2, 1) == 0 && r == limbs({2, 3}));
+    assert(mpn::rshift(r.data(), r.data(), 2, 1) == 0 && r == a);
+    assert(mpn::rshift(r.data(), a.data(), 2, 4) == 0x10000000u);
+    assert(mpn::lshift(r.data(), a.data(), 2, 0) == 0 && r == a);
+
+    for(int t = 0; t < 100; ++t)
+    {
+        size_t n = gen() % 30 + 1;
+        unsigned cnt = gen() % mpn::LIMB_BITS;
+        limbs x = random_limbs(n), y(n + 1);
+        y[n] = mpn::lshift(y.data(), x.data(), n, cnt);
+        assert(mpn::rshift(y.data(), y.data(), n + 1, cnt) == 0);
+        assert(y[n] == 0 && limbs(y.begin(), y.end() - 1) == x);
+    }
+}
+
+void check_bits()
+{
+    assert(mpn::clz(1) == 31 && mpn::clz(~limb(0)) == 0 && mpn::clz(0x00F00000u) == 8);
+    assert(mpn::ctz(1) == 0 && mpn::ctz(0x80000000u) == 31 && mpn::ctz(0x00F00000u) == 20);
+    assert(mpn::popcount(limb(0)) == 0 && mpn::popcount(~limb(0)) == 32);
+    for(size_t n = 0; n < 10; ++n)
+    {
+        limbs x = random_limbs(n);
+        size_t cnt = 0;
+        for(limb l : x)
+            for(; l; l >>= 1) cnt += l & 1;
+        assert(mpn::popcount(x.data(), n) == cnt);
+    }
+}
+
+void check_hash()
+{
+    limbs a{1, 2, 3, 4}, b{2, 1, 4, 3}, c{7, 7};
+    assert(mpn::hash(a.data(), 4) == mpn::hash(a.data(), 4));
+    assert(mpn::hash(a.data(), 4) != mpn::hash(b.data(), 4));
+    assert(mpn::hash(c.data(), 2) != mpn::hash(nullptr, 0));
+    assert(mpn::hash(a.data(), 4) != mpn::hash(a.data(), 4, 1));
+    // pinned, the hash may be stored
+    assert(mpn::hash(a.data(), 4) == 0x57f43a85bd12eea9ull);
+
+    // flipping any bit of a long number, through all the lanes and the tail
+    limbs x = random_limbs(41);
+    std::set<uint64_t> seen{mpn::hash(x.data(), x.size())};
+    for(size_t i = 0; i < x.size() * mpn::LIMB_BITS; ++i)
+    {
+        x[i / mpn::LIMB_BITS] ^= limb(1) << (i % mpn::LIMB_BITS);
+        seen.insert(mpn::hash(x.data(), x.size()));
+        x[i / mpn::LIMB_BITS] ^= limb(1) << (i % mpn::LIMB_BITS);
+    }
+    assert(seen.size() == x.size() * mpn::LIMB_BITS + 1);
+}
+
+void check_view()
+{
+    limbs buf{5, 0, 0}, zeros(3, 0);
+    mpn::const_view v(buf.data(), buf.size()), z(zeros.data(), 3), e(nullptr, 0);
+    assert(v.size() == 1 && v[0] == 5 && !v.is_zero());
+    assert(z.size() == 1 && z.is_zero() && e.is_zero());
+
+    limbs big = random_limbs(50);
+    mpn::const_view bv(big.data(), big.size());
+    ubig x(big), y(bv);
+    assert(x == y && x.compare(bv) == 0 && x.compare(v) > 0);
+    x += bv, x -= v;
+    assert(x == y + y - 5u);
+    x *= bv;
+    assert(x == (y + y - 5u) * y);
+    x /= bv;
+    assert(x == y + y - 5u);
+    x %= bv;
+    assert(x == y - 5u);
+    x = y;
+    x.add_eq(x.view());
+    assert(x == y + y);
+    x.multi_eq(x.view());
+    assert(x == (y + y) * (y + y));
+}
+
+void check()
+{
+    check_add_sub();
+    check_mul();
+    check_div();
+    check_montgomery();
+    check_shift();
+    check_bits();
+    check_hash();
+    check_view();
+}
@@ -0,0 +1,343 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "kedixa/number_theory.h"
+
+using namespace std;
+using ubig = kedixa::unsigned_bigint;
+using big = kedixa::bigint;
+using kedixa::random_bits;
+
+mt19937 gen(20201018);
+
+void check();
+
+int main()
+{
+    check();
+    return 0;
+}
+
+ubig euclid_gcd(ubig a, ubig b)
+{
+    while(b != 0)
+    {
+        ubig r = a % b;
+        a.swap(b), b.swap(r);
+    }
+    return a;
+}
+
+void check_gcd()
+{
+    ubig zero, one(1u);
+    assert(kedixa::gcd(zero, zero) == 0);
+    assert(kedixa::gcd(zero, ubig(12u)) == 12 && kedixa::gcd(ubig(12u), zero) == 12);
+    assert(kedixa::gcd(ubig(12u), ubig(18u)) == 6);
+    assert(kedixa::gcd(ubig(1u) << 100, ubig(1u) << 70) == (ubig(1u) << 70));
+
+    // consecutive Fibonacci numbers take the most steps
+    ubig f0(0u), f1(1u);
+    for(int i = 0; i < 3000; ++i)
+        f0 += f1, f0.swap(f1);
+    assert(kedixa::gcd(f0, f1) == 1 && kedixa::gcd(f1, f0) == 1);
+    assert(kedixa::gcd(f0 * 12345u, f1 * 12345u) == 12345);
+
+    const size_t sizes[] = {1, 2, 3, 4, 10, 40, 100};
+    for(size_t an : sizes)
+    for(size_t bn : sizes)
+    {
+        for(int t = 0; t < 5; ++t)
+        {
+            ubig g = random_bits(32 * (gen() % 3 + 1), gen);
+            ubig a = random_bits(32 * an, gen) * g, b = random_bits(32 * bn, gen) * g;
+            ubig r = kedixa::gcd(a, b);
+            assert(r == euclid_gcd(a, b) && r == kedixa::gcd(b, a));
+            assert(a % r == 0 && b % r == 0 && r % g == 0);
+        }
+    }
+    // sizes above the thresholds of the half gcd
+    const size_t large[] = {300, 500, 1500};
+    for(size_t n : large)
+    {
+        ubig g = random_bits(32 * (gen() % (n / 3) + 1), gen);
+        ubig a = random_bits(32 * n, gen) * g, b = random_bits(32 * (n - gen() % 3), gen) * g;
+        ubig c = random_bits(32 * (n / 2), gen) * g;
+        assert(kedixa::gcd(a, b) == euclid_gcd(a, b));
+        assert(kedixa::gcd(c, a) == euclid_gcd(a, c));
+    }
+    for(int i = 0; i < 30000; ++i)
+        f0 += f1, f0.swap(f1);
+    assert(kedixa::gcd(f0, f1) == 1);
+    assert(kedixa::gcd(f0 * f1, f1 * f1) == f1);
+
+    ubig a = random_bits(960, gen);
+    assert(kedixa::gcd(a, a) == a && kedixa::gcd(a * 3u, a) == a);
+    assert(kedixa::gcd(a, one) == 1);
+}
+
+// g = s * a + t * b and the bounds of the cofactors
+void check_gcdext(const big &a, const big &b)
+{
+    big g, s, t;
+    std::tie(g, s, t) = kedixa::gcdext(a, b);
+    big ua = a < 0 ? -a : a, ub = b < 0 ? -b : b;
+    big us = s < 0 ? -s : s, ut = t < 0 ? -t : t;
+    assert(g == big(kedixa::gcd(ua.to_ubigint(), ub.to_ubigint())));
+    assert(g == s * a + t * b);
+    if(a != 0 && b != 0)
+        assert(us * g <= ub && ut * g <= ua);
+}
+
+void check_gcdext()
+{
+    big g, s, t;
+    std::tie(g, s, t) = kedixa::gcdext(big(0), big(0));
+    assert(g == 0 && s == 0 && t == 0);
+    std::tie(g, s, t) = kedixa::gcdext(big(-7), big(0));
+    assert(g == 7 && s == -1 && t == 0);
+    std::tie(g, s, t) = kedixa::gcdext(big(0), big(-7));
+    assert(g == 7 && s == 0 && t == -1);
+    std::tie(g, s, t) = kedixa::gcdext(big(240), big(46));
+    assert(g == 2 && s == -9 && t == 47);
+    check_gcdext(big(12), big(12));
+    check_gcdext(big(-12), big(18));
+
+    // Lehmer's algorithm and the half gcd, with all signs
+    const size_t sizes[] = {1, 2, 3, 10, 100, 320, 1000};
+    for(size_t an : sizes)
+    for(size_t bn : sizes)
+    {
+        if(an * bn > 100000) continue;
+        ubig g = random_bits(32 * (gen() % 3 + 1), gen);
+        big a(random_bits(32 * an, gen) * g), b(random_bits(32 * bn, gen) * g);
+        check_gcdext(a, b);
+        check_gcdext(-a, b);
+        check_gcdext(b, -a);
+    }
+    ubig f0(0u), f1(1u);
+    for(int i = 0; i < 20000; ++i)
+        f0 += f1, f0.swap(f1);
+    check_gcdext(big(f1), big(f0));
+    check_gcdext(big(f0 * 3u), big(f1 * 3u));
+}
+
+// r^k <= n < (r + 1)^k
+bool is_root(const ubig &r, const ubig &n, unsigned k)
+{
+    ubig lo(1u), hi(1u);
+    for(unsigned i = 0; i < k; ++i)
+        lo *= r, hi *= r + 1u;
+    return lo <= n && n < hi;
+}
+
+void check_root()
+{
+    assert(kedixa::isqrt(ubig(0u)) == 0 && kedixa::isqrt(ubig(1u)) == 1);
+    assert(kedixa::isqrt(ubig(15u)) == 3 && kedixa::isqrt(ubig(16u)) == 4);
+    assert(kedixa::iroot(ubig(26u), 3) == 2 && kedixa::iroot(ubig(27u), 3) == 3);
+    assert(kedixa::iroot(ubig(12345u), 1) == 12345);
+    assert(kedixa::iroot(ubig(1u) << 1000, 1001) == 1);
+    bool caught = false;
+    try { kedixa::iroot(ubig(5u), 0); }
+    catch(const std::runtime_error &) { caught = true; }
+    assert(caught);
+
+    const size_t sizes[] = {1, 2, 3, 5, 20, 100};
+    for(size_t n : sizes)
+    {
+        ubig x = random_bits(32 * n, gen), r = kedixa::isqrt(x);
+        assert(is_root(r, x, 2));
+        assert(kedixa::isqrt(r * r) == r && kedixa::isqrt(r * r - 1u) == r - 1u);
+        for(unsigned k : {3u, 5u, 7u, 32u, 33u, 100u})
+            assert(is_root(kedixa::iroot(x, k), x, k));
+    }
+}
+
+void check_perfect_power()
+{
+    assert(kedixa::is_square(ubig(0u)) && kedixa::is_square(ubig(1u)));
+    assert(kedixa::is_square(ubig(144u)) && !kedixa::is_square(ubig(145u)));
+    assert(kedixa::is_perfect_power(ubig(0u)) && kedixa::is_perfect_power(ubig(1u)));
+    assert(!kedixa::is_perfect_power(ubig(2u)) && !kedixa::is_perfect_power(ubig(12u)));
+    assert(kedixa::is_perfect_power(ubig(1u) << 97) && kedixa::is_perfect_power(ubig(243u)));
+    assert(!kedixa::is_perfect_power(ubig(1u) << 1));
+
+    for(size_t n : {1, 3, 10, 50})
+    {
+        ubig x = random_bits(32 * n, gen) + 2u, sq = x * x;
+        assert(kedixa::is_square(sq) && !kedixa::is_square(sq + 1u));
+        assert(!kedixa::is_square(sq - 1u));
+        for(unsigned k : {2u, 3u, 5u, 6u, 13u})
+        {
+            ubig p(1u);
+            for(unsigned i = 0; i < k; ++i) p *= x;
+            assert(kedixa::is_perfect_power(p));
+            // x^k + 1 is a perfect power only for 2^3 + 1 = 3^2
+            assert(!kedixa::is_perfect_power(p + 1u));
+        }
+    }
+    // most numbers are rejected by the filters
+    size_t squares = 0;
+    for(unsigned i = 0; i < 10000; ++i)
+        squares += kedixa::is_square(ubig(i));
+    assert(squares == 100);
+}
+
+bool naive_is_prime(uint64_t n)
+{
+    if(n < 2) return false;
+    for(uint64_t d = 2; d * d <= n; ++d)
+        if(n % d == 0) return false;
+    return true;
+}
+
+ubig from_ull(uint64_t x)
+{
+    return ubig(vector<uint32_t>{uint32_t(x), uint32_t(x >> 32)});
+}
+
+void check_prime()
+{
+    for(unsigned i = 0; i < 20000; ++i)
+        assert(kedixa::is_probable_prime(ubig(i)) == naive_is_prime(i));
+    // Carmichael numbers, strong pseudoprimes to base 2, and products of
+    // two primes above the trial division bound
+    for(uint64_t x : {561ull, 41041ull, 825265ull, 3277ull, 4033ull, 4681ull, 8321ull,
+                      2053ull * 2063ull, 65537ull * 65539ull, 3215031751ull,
+                      3825123056546413051ull})
+        assert(!kedixa::is_probable_prime(from_ull(x)));
+    for(int t = 0; t < 300; ++t)
+    {
+        uint64_t x = (uint64_t(gen()) << 8 | gen() % 256) | 1;
+        assert(kedixa::is_probable_prime(from_ull(x)) == naive_is_prime(x));
+    }
+
+    ubig one(1u);
+    ubig m127 = (one << 127) - 1u, m521 = (one << 521) - 1u, m607 = (one << 607) - 1u;
+    assert(kedixa::is_probable_prime(m127) && kedixa::is_probable_prime(m521, 5));
+    assert(!kedixa::is_probable_prime(m127 * m521) && !kedixa::is_probable_prime(m607 * m607));
+    assert(!kedixa::is_probable_prime((one << 128) + 1u)); // 2^128 + 1 = 59649589127497217 * ...
+
+    for(unsigned i = 0; i < 5000; ++i)
+    {
+        ubig p = kedixa::next_prime(ubig(i));
+        unsigned q = i + 1;
+        while(!naive_is_prime(q)) ++q;
+        assert(p == q);
+    }
+    assert(kedixa::next_prime(m127 - 2u) == m127);
+    assert(kedixa::next_prime(m521 - 100u) == m521);
+    ubig x = random_bits(512, gen), p = kedixa::next_prime(x);
+    assert(p > x && kedixa::is_probable_prime(p, 10));
+    for(ubig y = x + 1u; y < p; y += 1u)
+        assert(!kedixa::is_probable_prime(y));
+}
+
+void check_product()
+{
+    vector<ubig> v;
+    assert(kedixa::product(v.begin(), v.end()) == 1);
+    ubig naive(1u);
+    for(int i = 0; i < 37; ++i)
+    {
+        v.push_back(random_bits(32 * (gen() % 50 + 1), gen));
+        naive *= v.back();
+        assert(kedixa::product(v.begin(), v.end()) == naive);
+    }
+    for(size_t i = 0; i < 200; ++i)
+        v.push_back(random_bits(3200, gen));
+    ubig p = kedixa::product(v);
+    assert(kedixa::product(v, 4) == p && kedixa::product(v.begin(), v.end(), 3) == p);
+
+    ubig f(1u);
+    for(unsigned n = 0; n <= 300; ++n)
+    {
+        if(n > 0) f *= n;
+        assert(kedixa::factorial(n) == f);
+    }
+    // 2000! has 5736 decimal digits and 499 trailing zeros
+    string s = kedixa::factorial(2000, 2).to_string();
+    assert(s.size() == 5736 && s.find_last_not_of('0') == s.size() - 500);
+
+    // Pascal's triangle
+    vector<ubig> row(1, ubig(1u));
+    for(unsigned n = 1; n <= 150; ++n)
+    {
+        vector<ubig> next(n + 1, ubig(1u));
+        for(unsigned k = 1; k < n; ++k)
+            next[k] = row[k-1] + row[k];
+        row.swap(next);
+        for(unsigned k = 0; k <= n + 1; ++k)
+            assert(kedixa::binomial(n, k) == (k <= n ? row[k] : ubig(0u)));
+    }
+    assert(kedixa::binomial(4000000000u, 3) == ubig("10666666658666666668000000000"));
+    assert(kedixa::binomial(3000, 1000) ==
+           kedixa::factorial(3000) / (kedixa::factorial(1000) * kedixa::factorial(2000)));
+}
+
+template<typename URBG>
+void check_random(URBG g)
+{
+    assert(random_bits(0, g) == 0u);
+    for(size_t bits : {1, 31, 32, 33, 64, 100, 1000})
+    {
+        bool top = false;
+        for(int i = 0; i < 50; ++i)
+        {
+            ubig x = random_bits(bits, g);
+            assert(x.bit_length() <= bits);
+            top = top || x.bit_length() == bits;
+        }
+        assert(top);
+    }
+
+    // every value of a small range about equally often
+    vector<int> cnt(6);
+    for(int i = 0; i < 60000; ++i)
+        ++cnt[kedixa::random_below(ubig(6u), g).to_uint()];
+    for(int c : cnt)
+        assert(c > 9000 && c < 11000);
+    // top limbs 0, 1 and 2, the last one taking the rejections
+    ubig bound("12884901888"); // 3 * 2^32
+    vector<int> tops(3);
+    for(int i = 0; i < 30000; ++i)
+    {
+        ubig x = kedixa::random_below(bound, g);
+        assert(x < bound);
+        ++tops[(x >> 32).to_uint()];
+    }
+    for(int c : tops)
+        assert(c > 9000 && c < 11000);
+    ubig big = random_bits(640, gen) + 1u;
+    for(int i = 0; i < 100; ++i)
+        assert(kedixa::random_below(big, g) < big);
+    assert(kedixa::random_below(ubig(1u), g) == 0);
+
+    bool e = false;
+    try { kedixa::random_below(ubig(0u), g); }
+    catch(const runtime_error &) { e = true; }
+    assert(e);
+}
+
+void check_random()
+{
+    check_random(mt19937(1));
+    check_random(mt19937_64(2));
+    check_random(minstd_rand(3));
+}
+
+void check()
+{
+    check_gcd();
+    check_gcdext();
+    check_root();
+    check_perfect_power();
+    check_prime();
+    check_product();
+    check_random();
+}
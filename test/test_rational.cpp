@@ -45,6 +45,34 @@ void check_relation()
     assert(one_1 == one_2 && one_2 == one_3);
     assert(ten_ma <= one);
     assert(ten_ma != neg_ten_ma);
+
+    // native 64-bit integers
+    rational seven_halves(ubigint(7u), ubigint(2u)), neg_seven_halves(-seven_halves);
+    assert(zero == 0 && one == 1 && one_3 == 1ULL && one != -1);
+    assert(seven_halves > 3 && seven_halves < 4 && 3 < seven_halves && seven_halves != 3);
+    assert(neg_seven_halves < -3 && neg_seven_halves > -4LL && neg_seven_halves < 0u);
+    assert(neg_one_third > -1 && neg_one_third < 0 && one_third > 0 && one_third < 1);
+    rational huge(ubigint("36893488147419103231"), ubigint(2u)); // (2^65 - 1) / 2
+    assert(huge > UINT64_MAX && huge > INT64_MAX && UINT64_MAX < huge);
+    assert(huge.compare(UINT64_MAX) > 0 && (-huge).compare(INT64_MIN) < 0);
+    rational just_below(ubigint("36893488147419103229"), ubigint(2u)); // 2^64 - 1.5
+    assert(just_below < UINT64_MAX && just_below > UINT64_MAX - 2);
+    // against the comparison of two rationals, near the product of the
+    // denominator and the integer
+    mt19937_64 gen(46);
+    for(int i = 0; i < 200; ++i)
+    {
+        uint64_t m = gen() >> (gen() % 64);
+        ubigint d = ubigint(to_string(gen() % 1000 + 2)) * ubigint(to_string(gen()));
+        ubigint um(to_string(m)), n = d * um + ubigint(to_string(gen() % 3));
+        rational r(n, d), rm(um);
+        assert(r.compare(m) == r.compare(rm));
+        assert(r.compare(m + 1) == r.compare(rational(um + 1u)));
+        if(m <= uint64_t(INT64_MAX))
+            assert((-r).compare(-int64_t(m)) == (-r).compare(-rm));
+    }
+    assert(zero.is_zero() && one_2.is_one() && !neg_one_ma.is_one() && !one_third.is_zero());
+    assert(zero.sgn() == 0 && neg_one_third.sgn() == -1 && ten_ma.sgn() == 1);
 }
 
 void check_add_sub()
@@ -56,6 +84,21 @@ void check_add_sub()
     assert(one + one_third + one_1 + one_1 + neg_one_third == rational(uthree));
     assert(one_third - neg_one_third + one_third == one);
     assert(one + neg_one_third == one_third + one_third);
+    rational one_fifth(uone, ubigint(5));
+    assert(one_third - one_fifth == rational(ubigint(2), ubigint(15)));
+    assert(one_fifth - one_third == rational(ubigint(2), ubigint(15), true));
+    assert(ten_ma - ten_ma == zero);
+
+    // 1/6 + 1/10 = 4/15, where the gcd of denominators is not 1
+    rational x(uone, ubigint(6)), y(uone, ubigint(10));
+    x += y;
+    assert(x == rational(ubigint(4), ubigint(15)));
+    x -= y;
+    assert(x == rational(uone, ubigint(6)));
+    x += x;
+    assert(x == one_third);
+    x -= x;
+    assert(x == zero);
 }
 
 void check_multi_div()
@@ -66,6 +109,21 @@ void check_multi_div()
     assert(one / neg_one_third == -(one / one_third));
     assert(ten_ma / neg_ten_ma == -one);
     assert(zero / ten_ma == zero);
+
+    rational x = neg_ten_ma;
+    x *= x;
+    assert(x == ten_ma * ten_ma);
+    x /= ten_ma;
+    assert(x == ten_ma);
+    x /= x;
+    assert(x == one);
+    x *= neg_one_third;
+    x *= rational(ubigint(6), uone, true);
+    assert(x == rational(ubigint(2)));
+    x /= rational(ubigint(4), ubigint(3), true);
+    assert(x == rational(ubigint(3), ubigint(2), true));
+    x *= zero;
+    assert(x == zero);
 }
 
 void check_hash()
@@ -77,6 +135,12 @@ void check_hash()
     st.insert(neg_one_ma);
     assert(st.find(neg_ten_ma) != st.end());
     assert(st.find(ten_ma) == st.end());
+
+    // a/b and b/a
+    hash<rational> h;
+    rational three(uthree), ma_ten(uma, uten);
+    assert(h(one_third) != h(three) && h(ten_ma) != h(ma_ten));
+    assert(h(one_ma) != h(neg_one_ma) && h(one) == h(one_3));
 }
 
 void check_convert()
@@ -93,6 +157,8 @@ void check_others()
 {
     assert(one_third.get_num() == uone);
     assert(neg_one_third.get_den() == uthree);
+    assert(&one_third.numerator() == &one_third.numerator());
+    assert(neg_one_third.denominator() == uthree);
     assert(neg_ten_ma.get_sign() == true);
     assert(neg_one_third.num_size() == 1);
     assert(neg_one_third.to_decimal(3) == "-0.333");
@@ -113,6 +179,15 @@ void check_others()
                         "5028841971693993751058209749445923"
                         "078164062862089986280348253421170679";
     assert(pi.to_decimal(100) == pi100);
+
+    rational y = neg_one_third;
+    y.reserve(16, 32);
+    assert(y.num_capacity() >= 16 && y.den_capacity() >= 32);
+    assert(y == neg_one_third);
+    y.clear();
+    assert(y == zero && y.den_capacity() >= 32);
+    y.shrink_to_fit();
+    assert(y == zero && y.den_capacity() < 32);
 }
 
 void check()
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+#include <exception>
+
+#include "kedixa/rns_int.h"
+#include "kedixa/number_theory.h"
+
+using namespace std;
+using ubig = kedixa::unsigned_bigint;
+using kedixa::rns_int;
+using kedixa::random_bits;
+
+mt19937 gen(20201018);
+
+void check();
+
+int main()
+{
+    check();
+    return 0;
+}
+
+void check_context()
+{
+    for(size_t bits : {0, 1, 30, 31, 100, 1000, 20000})
+    {
+        auto ctx = rns_int::make_context(bits);
+        const vector<uint32_t> &m = ctx->moduli();
+        assert(ctx->size() == m.size() && !m.empty());
+        assert(ctx->product() > (ubig(1u) << bits));
+        assert(m[0] == 2147483647u);
+        for(size_t i = 0; i < m.size(); ++i)
+            assert(m[i] > (1u << 30) && m[i] < (1u << 31) && (i == 0 || m[i] < m[i-1]));
+        ubig x = random_bits(bits + 32, gen) % ctx->product();
+        assert(ctx->from_rns(ctx->to_rns(x)) == x);
+    }
+
+    bool caught = false;
+    try { rns_int::make_context(vector<uint32_t>{}); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+    caught = false;
+    try { rns_int::make_context(vector<uint32_t>{2147483647u, 65537u}); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+    caught = false;
+    try { rns_int::make_context(vector<uint32_t>{2147483646u, 2147483644u}); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+}
+
+void check_arithmetic()
+{
+    auto ctx = rns_int::make_context(2000);
+    const ubig &M = ctx->product();
+    for(int t = 0; t < 50; ++t)
+    {
+        ubig a = random_bits(32 * (gen() % 70 + 1), gen) % M;
+        ubig b = random_bits(32 * (gen() % 70 + 1), gen) % M;
+        rns_int x(ctx, a), y(ctx, b);
+        assert(x.value() == a && x.modulus() == M);
+        assert((x + y).value() == (a + b) % M);
+        assert((x - y).value() == (a + M - b) % M);
+        assert((x * y).value() == a * b % M);
+        assert((-x).value() == (M - a) % M);
+        assert((x * x).value() == a * a % M);
+        x *= x;
+        assert(x.value() == a * a % M);
+    }
+    rns_int zero(ctx), one(ctx, 1u), big(ctx, 4000000000u);
+    assert(zero.is_zero() && !one.is_zero() && (-zero).is_zero());
+    assert(big.to_string() == "4000000000" && one - one == zero);
+
+    // a product chain whose result is below M is exact
+    auto chain = rns_int::make_context(64 * 500);
+    rns_int p(chain, 1u);
+    ubig q(1u);
+    for(int i = 0; i < 500; ++i)
+    {
+        uint32_t a = gen(), b = gen();
+        p *= rns_int(chain, a) + rns_int(chain, b);
+        q *= ubig(a) + b;
+    }
+    assert(p.value() == q);
+
+    // contexts of the same moduli work together
+    auto other = rns_int::make_context(ctx->moduli());
+    assert(rns_int(other, 5u) + rns_int(ctx, 6u) == rns_int(ctx, 11u));
+    bool caught = false;
+    try { rns_int(chain, 1u) + rns_int(ctx, 1u); }
+    catch(const runtime_error &) { caught = true; }
+    assert(caught);
+}
+
+void check()
+{
+    check_context();
+    check_arithmetic();
+}
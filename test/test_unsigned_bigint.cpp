@@ -3,7 +3,9 @@
 #include <string>
 #include <random>
 #include <unordered_set>
+#include <vector>
 #include <exception>
+#include <stdexcept>
 
 #include "kedixa/unsigned_bigint.h"
 using namespace std;
@@ -62,6 +64,16 @@ void check_relation()
     assert(hundred.compare(ten) > 0);
     assert(hundred.compare(hundred) == 0);
     assert(ubig("555555555555") > 0);
+
+    // native 64-bit integers
+    ubig big("18446744073709551616"), u64max("18446744073709551615");
+    assert(u64max == UINT64_MAX && big > UINT64_MAX && UINT64_MAX < big);
+    assert(ubig("4294967296") == 4294967296ULL && ubig("4294967296") != 4294967295LL);
+    assert(zero > -1 && -1 < zero && zero > INT64_MIN && zero != -1);
+    assert(b1.compare(123456789LL) == 0 && b1.compare(int64_t(-1)) > 0);
+    assert(hundred <= 100L && hundred >= 100L && 101ULL > hundred);
+    assert(zero.is_zero() && !one.is_zero() && one.is_one() && !two.is_one());
+    assert(!big.is_one() && zero.sgn() == 0 && big.sgn() == 1);
 }
 
 void check_add_sub()
@@ -110,6 +122,43 @@ void check_multi_div()
     assert(ub3 == fast_pow(ubig(1234567), 100));
     ubig ub4(string(12345, '4')), ub5(string(1234, '5'));
     assert(ub5 * ub4 / ub5 == ub4);
+
+    // compound assignment works in place
+    ubig ub6 = ub5, ub7(string(20, '7'));
+    ub6 *= ub7;
+    assert(ub6 == ub5 * ub7);
+    ub6 *= ub6;
+    assert(ub6 == (ub5 * ub7) * (ub5 * ub7));
+    ub6 /= ub7;
+    assert(ub6 == ub5 * ub5 * ub7);
+    ub6 %= ub5 + one;
+    assert(ub6 == (ub5 * ub5 * ub7) % (ub5 + one));
+    ub6 %= ub6;
+    assert(ub6 == 0);
+    ubig ub8 = ub7;
+    ub8 /= ub8;
+    assert(ub8 == 1);
+    ub8 %= 1;
+    assert(ub8 == 0);
+
+    mt19937 gen(rd());
+    for(size_t i = 0; i < 100; ++i)
+    {
+        vector<unsigned> va(gen() % 20 + 1), vb(gen() % 20 + 1);
+        for(auto &x : va) x = gen();
+        for(auto &x : vb) x = gen();
+        ubig a(va), b(vb);
+        if(b == 0) continue;
+        auto qr = a.div_mod(b);
+        assert(qr.first * b + qr.second == a);
+        assert(qr.second < b);
+        ubig c = a;
+        c /= b;
+        assert(c == qr.first);
+        c = a;
+        c %= b;
+        assert(c == qr.second);
+    }
 }
 
 void check_hash()
@@ -121,6 +170,12 @@ void check_hash()
     st.insert(ten);
     st.insert(hundred);
     assert(st.find(zero) != st.end());
+
+    // the limbs {2, 1} and {1, 2}, and {5, 5} whose xor of the limbs is 0
+    hash<ubig> h;
+    ubig p1("4294967298"), p2("8589934593"), p3("21474836485");
+    assert(h(p1) != h(p2) && h(p3) != h(zero));
+    assert(h(ubig("123456789012345678901234567890")) == h(ubig("123456789012345678901234567890")));
 }
 
 void check_convert()
@@ -155,6 +210,229 @@ void check_others()
     assert((two & ten) == (2 & 10));
     assert((b3 << 5).to_string() == to_string(4294967295LL << 5));
     assert(b3 >> 5 == 4294967295U >> 5);
+
+    ubig ub1;
+    ub1.reserve(64);
+    assert(ub1.capacity() >= 64);
+    for(size_t i = 0; i < 40; ++i)
+        ub1 *= b3, ub1 += b2;
+    assert(ub1.size() <= 41 && ub1.capacity() >= 64);
+    ubig ub2 = ub1;
+    ub1 *= ub2;
+    ub1 /= ub2;
+    assert(ub1 == ub2);
+    assert(ub1.capacity() >= 64);
+    ub1.clear();
+    assert(ub1 == 0 && ub1.capacity() >= 64);
+    ub1.shrink_to_fit();
+    assert(ub1 == 0 && ub1.capacity() < 64);
+
+    // copies of a large number share the limbs until one of them is written
+    ubig big = fast_pow(b3, 100), saved(big.to_string());
+    ubig copy1 = big, copy2 = copy1;
+    big += 1u;
+    assert(copy1 == saved && copy2 == saved && big == saved + 1u);
+    copy1 >>= 40;
+    assert(copy2 == saved && copy1 == saved >> 40);
+    copy2 *= two;
+    assert(copy2 == saved + saved && big - 1u == saved);
+    ubig small = b3, copy3 = small;
+    small -= one;
+    assert(copy3 == b3 && small == b3 - one);
+}
+
+void check_shift()
+{
+    assert(zero.shl(100) == 0 && zero.shr(3) == 0 && b3.shr(32) == 0 && b3.shr(1000) == 0);
+    assert(b3.shl(0) == b3 && b3.shr(0) == b3 && one.shl(64) == ubig("18446744073709551616"));
+
+    mt19937 gen(rd());
+    ubig big = fast_pow(b3, 150);
+    for(int t = 0; t < 100; ++t)
+    {
+        size_t k = gen() % 300;
+        ubig l = big.shl(k), r = big.shr(k);
+        assert(l == big * fast_pow(two, int(k)) && r == big / fast_pow(two, int(k)));
+        assert(l.shr(k) == big && (big << k) == l && (big >> k) == r);
+
+        // in place on shared, short and roomy buffers
+        ubig copy = big, roomy;
+        roomy.reserve(big.size() + 20);
+        roomy = big;
+        copy <<= k;
+        roomy <<= k % 64;
+        assert(copy == l && roomy == big.shl(k % 64) && big == l.shr(k));
+        copy = big;
+        copy >>= k;
+        assert(copy == r && big == l.shr(k));
+    }
+}
+
+void check_bits()
+{
+    assert(zero.bit_length() == 0 && zero.popcount() == 0 && zero.count_trailing_zeros() == 0);
+    assert(one.bit_length() == 1 && b3.bit_length() == 32 && (b3 + 1u).bit_length() == 33);
+    assert(b3.popcount() == 32 && hundred.popcount() == 3 && hundred.count_trailing_zeros() == 2);
+    assert(!zero.test_bit(0) && !zero.test_bit(1000) && hundred.test_bit(2) && !hundred.test_bit(3));
+
+    mt19937 gen(rd());
+    for(int t = 0; t < 200; ++t)
+    {
+        ubig x(vector<uint32_t>{uint32_t(gen()), uint32_t(gen()), 0, uint32_t(gen()), uint32_t(gen())});
+        x <<= gen() % 100;
+        size_t len = x.bit_length(), ones = 0, k = gen() % (len + 40);
+        for(size_t i = 0; i < len + 40; ++i)
+        {
+            bool b = x.test_bit(i);
+            assert(b == ((x >> i) % 2u == 1u));
+            ones += b;
+        }
+        assert(x.popcount() == ones && (x >> (len - 1)) == 1u && (x >> len) == 0u);
+        assert(x.test_bit(x.count_trailing_zeros()) && (x >> x.count_trailing_zeros()) << x.count_trailing_zeros() == x);
+
+        ubig y = x, shared = x;
+        bool b = y.test_bit(k);
+        y.set_bit(k);
+        assert(y.test_bit(k) && y == (b ? x : x + (one << k)));
+        y.clear_bit(k);
+        assert(!y.test_bit(k) && y == (b ? x - (one << k) : x));
+        y.flip_bit(k).flip_bit(k);
+        assert(!y.test_bit(k));
+        y.flip_bit(k);
+        assert(y == x.set_bit(k) && shared.test_bit(k) == b);
+
+        size_t pos = gen() % (len + 40), n = gen() % 100;
+        assert(x.extract_bits(pos, n) == (x >> pos) % (one << n));
+    }
+    ubig high = one << 200;
+    assert(high.clear_bit(200) == 0 && high.size() == 1);
+    assert(b3.extract_bits(0, 0) == 0 && b3.extract_bits(4, 64) == b3 >> 4);
+}
+
+// x^e % m by square and multiply with operator% after every step
+ubig naive_powmod(ubig x, ubig e, const ubig &m)
+{
+    ubig r = one % m;
+    x %= m;
+    while(e != 0)
+    {
+        if(e.div_mod(2).second == 1) r = r * x % m;
+        x = x * x % m;
+        e >>= 1;
+    }
+    return r;
+}
+
+void check_powmod()
+{
+    assert(b1.powmod(zero, hundred) == 1);
+    assert(b1.powmod(b2, one) == 0);
+    assert(zero.powmod(b2, b3) == 0);
+    assert(two.powmod(ten, hundred) == 24);
+    // Fermat's little theorem, 2^127 - 1 and 2^521 - 1 are primes
+    ubig p127 = (one << 127) - 1u, p521 = (one << 521) - 1u;
+    assert(b2.powmod(p127 - 1u, p127) == 1);
+    assert(b3.powmod(p521 - 1u, p521) == 1);
+    assert(b3.powmod(p521, p521) == b3);
+
+    mt19937 gen(rd());
+    auto rand_ubig = [&gen](size_t limbs) {
+        vector<ubig::uint_type> v(limbs);
+        for(auto &x : v) x = gen();
+        return ubig(v);
+    };
+    for(int t = 0; t < 40; ++t)
+    {
+        // odd and even moduli, the base may be larger than the modulus
+        ubig m = rand_ubig(gen() % 40 + 1), x = rand_ubig(gen() % 50 + 1);
+        ubig e = rand_ubig(gen() % 3 + 1);
+        if(m == 0) m = ubig(7);
+        assert(x.powmod(e, m) == naive_powmod(x, e, m));
+        m += 1u;
+        assert(x.powmod(e, m) == naive_powmod(x, e, m));
+    }
+    bool thrown = false;
+    try { b1.powmod(one, zero); }
+    catch(const std::runtime_error &) { thrown = true; }
+    assert(thrown);
+}
+
+ubig gcd_naive(ubig a, ubig b)
+{
+    while(b != 0)
+    {
+        ubig r = a % b;
+        a.swap(b), b.swap(r);
+    }
+    return a;
+}
+
+void check_invert()
+{
+    assert(ubig(3u).invert(ubig(7u)) == 5);
+    assert(ubig(10u).invert(ubig(7u)) == 5);
+    assert(ubig(5u).invert(one) == 0);
+    assert(one.invert(two) == 1);
+    bool caught = false;
+    try { ubig(6u).invert(ubig(9u)); }
+    catch(const std::runtime_error &) { caught = true; }
+    assert(caught);
+
+    mt19937 gen(rd());
+    auto rand_ubig = [&gen](size_t limbs) {
+        vector<ubig::uint_type> v(limbs);
+        for(auto &x : v) x = gen();
+        return ubig(v);
+    };
+    // odd and even moduli, of the sizes of Lehmer's algorithm and the half gcd
+    for(size_t n : {1, 2, 5, 40, 400})
+    for(int t = 0; t < 4; ++t)
+    {
+        ubig m = rand_ubig(n) + 2u, x = rand_ubig(gen() % (n + 2) + 1);
+        if(t % 2) m = m * 2u;
+        if(gcd_naive(x, m) != 1) x = m - 1u;
+        ubig y = x.invert(m);
+        assert(y < m && x * y % m == 1);
+    }
+}
+
+void check_word()
+{
+    // the arithmetic in a machine word, and its overflow into limbs
+    ubig u64max("18446744073709551615"), two64("18446744073709551616");
+    ubig two32("4294967296"), two32m1("4294967295"), two32p1("4294967297");
+    assert(u64max + one == two64 && two64 - one == u64max && two64 - u64max == one);
+    assert(two32 * two32 == two64 && two32m1 * two32p1 == u64max);
+    assert(u64max * zero == zero && (u64max - u64max).size() == 1);
+    ubig t(u64max);
+    t += t;
+    assert(t == two64 * two - two);
+    t = u64max;
+    t *= t;
+    assert(t == ubig("340282366920938463426481119284349108225"));
+    t = two32;
+    t -= t;
+    assert(t == zero && t.size() == 1);
+    bool thrown = false;
+    try { t = one; t -= two32; } catch(const std::underflow_error&) { thrown = true; }
+    assert(thrown && t == one);
+
+    mt19937_64 gen(rd());
+    for(int i = 0; i < 10000; ++i)
+    {
+        uint64_t x = gen() >> (gen() % 64), y = gen() >> (gen() % 64);
+        ubig bx(vector<uint32_t>{uint32_t(x), uint32_t(x >> 32)});
+        ubig by(vector<uint32_t>{uint32_t(y), uint32_t(y >> 32)});
+        ubig s = bx + by, p = bx * by;
+        assert(s - by == bx && (y == 0 || p / by == bx));
+        ubig u(bx);
+        u += by;
+        assert(u == s);
+        u = bx;
+        u *= by;
+        assert(u == p);
+        if(x >= y) assert(bx - by == ubig(vector<uint32_t>{uint32_t(x - y), uint32_t((x - y) >> 32)}));
+    }
 }
 
 void check()
@@ -166,5 +444,10 @@ void check()
     check_hash();
     check_convert();
     check_others();
+    check_shift();
+    check_bits();
+    check_powmod();
+    check_invert();
+    check_word();
 }
 